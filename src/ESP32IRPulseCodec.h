@@ -9,6 +9,7 @@
 #endif
 
 #include "esp32irpulsecodec_version.h"
+#include "esp32irpulsecodec_config.h"
 #include <vector>
 #include <array>
 #include <deque>
@@ -20,7 +21,13 @@
 #include <driver/rmt_rx.h>
 #include <driver/rmt_encoder.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "core/spsc_ring.h"
+#include "core/rx_event_ring.h"
+#include "core/rx_fan_in.h"
+#include "core/frame_split_state.h"
 
 #ifndef ESP32IR_PACKED
 #define ESP32IR_PACKED __attribute__((packed))
@@ -56,6 +63,60 @@ namespace esp32ir
     FujitsuAC,
   };
 
+  // Whether the codec for p is compiled in (ESP32IR_ENABLE_<PROTOCOL>, see esp32irpulsecodec_config.h).
+  constexpr bool protocolEnabled(Protocol p)
+  {
+    switch (p)
+    {
+    case Protocol::RAW:
+      return true;
+    case Protocol::NEC:
+      return ESP32IR_ENABLE_NEC != 0;
+    case Protocol::SONY:
+      return ESP32IR_ENABLE_SONY != 0;
+    case Protocol::AEHA:
+      return ESP32IR_ENABLE_AEHA != 0;
+    case Protocol::Panasonic:
+      return ESP32IR_ENABLE_PANASONIC != 0;
+    case Protocol::JVC:
+      return ESP32IR_ENABLE_JVC != 0;
+    case Protocol::Samsung:
+      return ESP32IR_ENABLE_SAMSUNG != 0;
+    case Protocol::Samsung36:
+      return ESP32IR_ENABLE_SAMSUNG36 != 0;
+    case Protocol::LG:
+      return ESP32IR_ENABLE_LG != 0;
+    case Protocol::Denon:
+      return ESP32IR_ENABLE_DENON != 0;
+    case Protocol::RC5:
+      return ESP32IR_ENABLE_RC5 != 0;
+    case Protocol::RC6:
+      return ESP32IR_ENABLE_RC6 != 0;
+    case Protocol::Apple:
+      return ESP32IR_ENABLE_APPLE != 0;
+    case Protocol::Pioneer:
+      return ESP32IR_ENABLE_PIONEER != 0;
+    case Protocol::Toshiba:
+      return ESP32IR_ENABLE_TOSHIBA != 0;
+    case Protocol::Mitsubishi:
+      return ESP32IR_ENABLE_MITSUBISHI != 0;
+    case Protocol::Hitachi:
+      return ESP32IR_ENABLE_HITACHI != 0;
+    case Protocol::DaikinAC:
+      return ESP32IR_ENABLE_DAIKINAC != 0;
+    case Protocol::PanasonicAC:
+      return ESP32IR_ENABLE_PANASONICAC != 0;
+    case Protocol::MitsubishiAC:
+      return ESP32IR_ENABLE_MITSUBISHIAC != 0;
+    case Protocol::ToshibaAC:
+      return ESP32IR_ENABLE_TOSHIBAAC != 0;
+    case Protocol::FujitsuAC:
+      return ESP32IR_ENABLE_FUJITSUAC != 0;
+    default:
+      return false;
+    }
+  }
+
   // Forward declare split policy for presets
   enum class RxSplitPolicy : uint8_t;
 
@@ -223,6 +284,78 @@ namespace esp32ir
     KEEP_GAP_IN_FRAME,
   };
 
+  // What the RX ISR does when the event queue is full
+  enum class RxOverflowPolicy : uint8_t
+  {
+    DROP_OLDEST = 0, // discard the oldest queued capture; next result is OVERFLOW
+    DROP_NEWEST,     // discard the new capture; next result is OVERFLOW
+    COUNT_ONLY,      // discard the new capture and only count it
+  };
+
+  // Captures lost in the RX path, per cause
+  struct RxLossCounters
+  {
+    uint32_t droppedOldest;
+    uint32_t droppedNewest;
+    uint32_t countedOnly;
+    uint32_t bufferStarved; // no free RMT buffer to re-arm reception
+  };
+
+  // Time from the RX notification waking the consumer (poll with timeout, or the decode task) to a result
+  // being handed over (handler call, poll return, or queued for poll by the decode task).
+  struct RxDeliveryLatency
+  {
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint32_t samples;
+  };
+
+  // Log2 latency histograms of received frames: bucket i counts [2^i, 2^(i+1)) us (bucket 0 also 0 us,
+  // the last bucket everything longer).
+  struct RxLatencyHistogram
+  {
+    static constexpr size_t kBuckets = 20; // up to ~0.5 s
+    uint32_t queued[kBuckets];  // RX ISR -> picked up for decoding (RxTiming::capturedUs -> decode start)
+    uint32_t decode[kBuckets];  // decode start -> RxTiming::decodedUs
+  };
+
+  // Receiver runtime counters since begin() or resetStats(); each counter wraps at 2^32.
+  struct RxStats
+  {
+    static constexpr size_t kProtocols = static_cast<size_t>(Protocol::FujitsuAC) + 1; // indexed by Protocol
+    uint32_t rmtEvents;    // RMT receive events converted
+    uint32_t symbols;      // RMT symbols in those events
+    uint32_t framesSplit;  // frames cut out of the captures
+    uint32_t framesNoise;  // frames dropped as noise (below minEdges / minFrameUs)
+    uint32_t glitches;     // pulses merged away by the glitch filter (setGlitchFilterUs)
+    uint32_t decodeMisses; // frames that no enabled decoder accepted
+    uint32_t truncations;  // captures that filled an RMT buffer
+    uint32_t overflows;    // OVERFLOW results
+    uint32_t restarts;     // reception re-armed by poll()/the decode task after the ISR had no free buffer
+    uint32_t queueDrops;   // captures lost in the event ring (sum of RxLossCounters) + results dropped by the decode task
+    uint32_t decoded[kProtocols];      // DECODED results per protocol; [RAW] counts RAW_ONLY results
+    uint32_t decodeCycles[kProtocols]; // CPU cycles spent in each protocol's decoder, failed attempts included
+  };
+
+  // Receive mode, protocols and split parameters of a Receiver (the values of the matching setters).
+  // 0 / empty fields are resolved at begin() from the protocols' recommendations, as with the setters.
+  struct RxConfig
+  {
+    bool rawOnly{false};
+    bool rawPlusKnown{false};
+    bool knownWithoutAC{false};
+    std::vector<Protocol> protocols; // empty: every known protocol (knownWithoutAC: without AC)
+    uint32_t frameGapUs{0};
+    uint32_t hardGapUs{0};
+    uint32_t minFrameUs{0};
+    uint32_t maxFrameUs{0};
+    uint16_t minEdges{0};
+    uint16_t frameCountMax{0};
+    bool splitPolicySet{false}; // false: DROP_GAP, or KEEP_GAP_IN_FRAME in the RAW modes
+    RxSplitPolicy splitPolicy{RxSplitPolicy::DROP_GAP};
+    uint32_t glitchFilterUs{0};
+  };
+
   // ITPS core types
   struct ITPSFrame
   {
@@ -232,27 +365,234 @@ namespace esp32ir
     uint8_t flags;
   };
 
+  // Non-owning, trivially copyable view of ITPS frames: an ITPSBuffer (view()), the receiver's arena, or a
+  // learned code in flash, e.g.
+  //   static const int8_t kSeq[] = {90, -45, 6, -6, ...};
+  //   static const esp32ir::ITPSFrame kFrames[] = {{10, sizeof(kSeq), kSeq, 0}};
+  //   tx.send(esp32ir::ITPSView{kFrames, 1});
+  // Accepted wherever an ITPSBuffer is read (Transmitter::send, Receiver::decode, decodeX) without copying it.
+  class ITPSBuffer;
+
+  struct ITPSView
+  {
+    const esp32ir::ITPSFrame *frames{nullptr};
+    uint16_t count{0};
+
+    ITPSView() = default;
+    constexpr ITPSView(const esp32ir::ITPSFrame *frames_, uint16_t count_) : frames(frames_), count(count_) {}
+    // Any ITPSBuffer converts (valid until the buffer changes).
+    ITPSView(const esp32ir::ITPSBuffer &buf);
+
+    uint16_t frameCount() const { return frames ? count : 0; }
+    const esp32ir::ITPSFrame &frame(uint16_t i) const;
+    uint32_t totalTimeUs() const;
+  };
+
+  // Frames are stored back to back in one entry arena, with a table of ITPSFrame (seq points into the arena).
+  // Up to kInlineEntries entries in kInlineFrames frames live inside the object, so a typical single-frame
+  // remote (NEC 68 entries, AEHA ~100) never touches the heap; past that both grow on the heap as one block.
+  // A buffer given fixed storage (useStorage, StaticITPSBuffer) never allocates: what does not fit is dropped
+  // and reported by overflowed().
   class ITPSBuffer
   {
   public:
+    static constexpr uint16_t kInlineEntries = 200;
+    static constexpr uint16_t kInlineFrames = 2;
+
     ITPSBuffer() = default;
+    ITPSBuffer(const ITPSBuffer &other);
+    ITPSBuffer(ITPSBuffer &&other) noexcept;
+    ITPSBuffer &operator=(const ITPSBuffer &other);
+    ITPSBuffer &operator=(ITPSBuffer &&other) noexcept;
 
+    // clear() keeps the frame storage allocated so the buffer can be refilled without heap allocations.
     void clear();
-    void addFrame(const esp32ir::ITPSFrame &f);
+    // Returns false if the frame did not fit fixed storage (the entries that fit are kept).
+    bool addFrame(const esp32ir::ITPSFrame &f);
+    // Replace the contents with a copy of the frames of `view`.
+    void assign(const esp32ir::ITPSView &view);
+    // Append a frame of `len` entries and return its storage for the caller to fill in place (no intermediate
+    // vector). Fill it before reading the buffer; the pointer is valid until the next append.
+    // nullptr if it does not fit fixed storage.
+    int8_t *appendFrame(uint16_t T_us, uint16_t len, uint8_t flags = 0);
+    // Build a frame entry by entry: start an empty frame, then append entries to the last frame.
+    bool beginFrame(uint16_t T_us, uint8_t flags = 0);
+    bool appendEntry(int8_t v);
+    // Preallocate storage for `frames` frames of up to `entriesPerFrame` entries each (no-op on fixed storage).
+    void reserve(uint16_t frames, uint16_t entriesPerFrame);
+    // Store frames in caller-owned arrays from now on and never allocate (clears the buffer and frees its heap
+    // storage). The arrays must outlive the buffer. nullptr arrays return to the default growing storage.
+    void useStorage(int8_t *entries, size_t entryCapacity, esp32ir::ITPSFrame *frames, uint16_t frameCapacity);
+    // Something did not fit fixed storage since the last clear()/assign().
+    bool overflowed() const { return overflowed_; }
 
     uint16_t frameCount() const;
     const esp32ir::ITPSFrame &frame(uint16_t i) const;
+    // Entries of all frames.
+    size_t entryCount() const { return used_; }
+    // Valid until the buffer changes.
+    esp32ir::ITPSView view() const { return {frames_, count_}; }
+    // Computed once per change and cached.
     uint32_t totalTimeUs() const;
 
   private:
-    struct FrameStorage
+    friend class Receiver;
+    size_t reservedBytes() const;
+    bool growEntries(size_t need);
+    bool growFrames(uint16_t need);
+    void rebase(const int8_t *oldBase);
+    void copyFrom(const ITPSBuffer &other);
+
+    int8_t inlineEntries_[kInlineEntries];
+    esp32ir::ITPSFrame inlineFrames_[kInlineFrames];
+    std::vector<int8_t> heapEntries_;
+    std::vector<esp32ir::ITPSFrame> heapFrames_;
+    int8_t *entries_{inlineEntries_};
+    esp32ir::ITPSFrame *frames_{inlineFrames_};
+    size_t entryCap_{kInlineEntries};
+    size_t used_{0};
+    uint16_t frameCap_{kInlineFrames};
+    uint16_t count_{0};
+    mutable uint32_t totalUs_{0};
+    mutable bool totalValid_{true};
+    bool fixed_{false};
+    bool overflowed_{false};
+  };
+
+  inline ITPSView::ITPSView(const esp32ir::ITPSBuffer &buf) : ITPSView(buf.view()) {}
+
+  // ITPSBuffer with its storage inside the object (MaxEntries entries in up to MaxFrames frames): never touches
+  // the heap, so it can be a global, a member or a stack variable of a heap-free build. Copies stay in their own
+  // storage; a source that does not fit sets overflowed().
+  template <size_t MaxEntries, uint16_t MaxFrames = 1>
+  class StaticITPSBuffer : public ITPSBuffer
+  {
+    static_assert(MaxEntries > 0 && MaxFrames > 0, "StaticITPSBuffer needs room for one entry and one frame");
+
+  public:
+    StaticITPSBuffer() { useStorage(staticEntries_, MaxEntries, staticFrames_, MaxFrames); }
+    StaticITPSBuffer(const StaticITPSBuffer &other) : StaticITPSBuffer() { assign(other); }
+    StaticITPSBuffer(const esp32ir::ITPSView &view) : StaticITPSBuffer() { assign(view); }
+    StaticITPSBuffer &operator=(const StaticITPSBuffer &other)
+    {
+      assign(other);
+      return *this;
+    }
+    StaticITPSBuffer &operator=(const esp32ir::ITPSView &view)
+    {
+      assign(view);
+      return *this;
+    }
+
+  private:
+    int8_t staticEntries_[MaxEntries];
+    esp32ir::ITPSFrame staticFrames_[MaxFrames];
+  };
+
+  // Compact ITPS for storing many learned codes. A normalized frame (runs split at ±127 only) is stored as its
+  // run-merged mark/space lengths: a per-frame palette of duration clusters, and per run a 1-4 bit palette index
+  // plus an r-bit offset from the cluster base (r fits the capture's jitter; 0 for encoded frames), where the
+  // all-ones index escapes to a 16-bit length. Entries are stored verbatim when that is smaller or the frame is
+  // not normalized. Lossless. Byte layout (little-endian), safe to keep in flash:
+  //   u8 version (kCompactITPSVersion), u16 frameCount, then per frame:
+  //   u16 T_us, u16 len (entries), u8 flags, u8 mode (0: verbatim; else index bits | offset bits << 3),
+  //   u8 paletteSize, u16 palette[paletteSize], u16 dataBytes, u8 data[dataBytes] (values packed LSB first).
+  constexpr uint8_t kCompactITPSVersion = 1;
+
+  // Non-owning view of compact ITPS bytes (valid while the bytes are).
+  class CompactITPSView
+  {
+  public:
+    // Reads the entries of one frame in order, unpacking them on the fly.
+    class Reader
     {
-      esp32ir::ITPSFrame frame;
-      std::vector<int8_t> data;
+    public:
+      uint16_t T_us() const { return T_us_; }
+      uint16_t len() const { return len_; }
+      uint8_t flags() const { return flags_; }
+      // Next entry; false after the last one (or on malformed data).
+      bool next(int8_t &v);
+
+    private:
+      friend class CompactITPSView;
+      bool readBits(uint8_t n, uint32_t &v);
+      bool readRun(uint32_t &counts);
+
+      const uint8_t *palette_{nullptr};
+      const uint8_t *data_{nullptr};
+      size_t dataBits_{0};
+      size_t bitPos_{0};
+      uint32_t runLeft_{0};
+      uint16_t T_us_{0};
+      uint16_t len_{0};
+      uint16_t left_{0};
+      uint8_t flags_{0};
+      uint8_t indexBits_{0};
+      uint8_t offsetBits_{0};
+      uint8_t paletteSize_{0};
+      bool runMark_{false};
     };
-    std::vector<FrameStorage> frames_;
+
+    CompactITPSView() = default;
+    constexpr CompactITPSView(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    // 0 if the bytes are not compact ITPS of a known version, or a frame runs past the end or has an invalid mode.
+    uint16_t frameCount() const;
+    Reader frame(uint16_t i) const;
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+    uint32_t totalTimeUs() const;
+    // Expand into ordinary frames; false on malformed data or when out does not fit (fixed storage).
+    bool unpack(esp32ir::ITPSBuffer &out) const;
+
+  private:
+    // Byte offset of frame i's header, or 0.
+    size_t frameOffset(uint16_t i) const;
+
+    const uint8_t *data_{nullptr};
+    size_t size_{0};
+  };
+
+  // Owning compact ITPS.
+  class CompactITPS
+  {
+  public:
+    // Pack the frames of `view` (replacing the contents); false for frames that are not packable (empty).
+    bool assign(const esp32ir::ITPSView &view);
+    void clear() { bytes_.clear(); }
+    esp32ir::CompactITPSView view() const { return {bytes_.data(), bytes_.size()}; }
+    operator esp32ir::CompactITPSView() const { return view(); }
+    const uint8_t *data() const { return bytes_.data(); }
+    size_t size() const { return bytes_.size(); }
+
+  private:
+    std::vector<uint8_t> bytes_;
+  };
+
+  // Run-merged mark/space duration, the unit the protocol decoders work on.
+  struct Pulse
+  {
+    bool mark;
+    uint32_t us;
   };
 
+  // Non-owning view of run-merged pulses (alternating levels, first one a Mark).
+  struct PulseView
+  {
+    const esp32ir::Pulse *data;
+    size_t count;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const esp32ir::Pulse &operator[](size_t i) const { return data[i]; }
+  };
+
+  // Merge frame 0 of raw into pulses stored in caller-provided storage (pulses past capacity are dropped).
+  // Build it once per frame and pass it to any number of decodeX(const PulseView &, ...) calls.
+  esp32ir::PulseView makePulseView(const esp32ir::ITPSView &raw, esp32ir::Pulse *storage, size_t capacity);
+  // Same for frame 0 of compact ITPS, read directly from the packed entries.
+  esp32ir::PulseView makePulseView(const esp32ir::CompactITPSView &raw, esp32ir::Pulse *storage, size_t capacity);
+
   struct ProtocolMessage
   {
     esp32ir::Protocol protocol;
@@ -265,6 +605,16 @@ namespace esp32ir
   // Returns false if protocol/length is unsupported.
   bool buildTxBitstream(const esp32ir::ProtocolMessage &message, std::vector<uint8_t> &out, uint16_t &bitCount);
 
+  // esp_timer_get_time() stamps of a received frame (0: unknown, e.g. results of decode()).
+  // Edges are derived from the ISR stamp and the RMT durations, so they are as exact as T_us.
+  struct RxTiming
+  {
+    int64_t firstEdgeUs; // first mark of the frame
+    int64_t lastEdgeUs;  // end of its last mark
+    int64_t capturedUs;  // RX ISR received the RMT event holding the end of the frame
+    int64_t decodedUs;   // decoding finished
+  };
+
   struct RxResult
   {
     esp32ir::RxStatus status;
@@ -272,6 +622,28 @@ namespace esp32ir
     esp32ir::ProtocolMessage message;
     esp32ir::ITPSBuffer raw;
     std::vector<uint8_t> payloadStorage;
+    esp32ir::RxTiming timing{};
+    uint8_t source{0}; // index of the receiving member in its ReceiverGroup (0 outside a group)
+  };
+
+  // RxResult whose raw frames live in fixed storage and whose payload storage is reserved up front, so filling it
+  // never allocates. A RAW result whose frames do not fit is reported as OVERFLOW (the head of the capture is kept).
+  template <size_t MaxEntries, uint16_t MaxFrames = 1>
+  struct StaticRxResult : public RxResult
+  {
+    static constexpr size_t kPayloadReserve = 16; // longest non-AC payload (Samsung36) is 9 bytes
+
+    StaticRxResult()
+    {
+      raw.useStorage(staticEntries_, MaxEntries, staticFrames_, MaxFrames);
+      payloadStorage.reserve(kPayloadReserve);
+    }
+    StaticRxResult(const StaticRxResult &) = delete;
+    StaticRxResult &operator=(const StaticRxResult &) = delete;
+
+  private:
+    int8_t staticEntries_[MaxEntries];
+    esp32ir::ITPSFrame staticFrames_[MaxFrames];
   };
 
   namespace payload
@@ -530,6 +902,11 @@ namespace esp32ir
   } // namespace ac
 
   // Receiver
+  // Receives each matching result; `result` is only valid during the call.
+  using RxHandler = void (*)(const esp32ir::RxResult &result, void *user);
+
+  class ReceiverGroup;
+
   class Receiver
   {
   public:
@@ -555,63 +932,390 @@ namespace esp32ir
     bool setMinEdges(uint16_t minEdges);
     bool setFrameCountMax(uint16_t frameCountMax);
     bool setSplitPolicy(RxSplitPolicy policy);
+    // Size all RX working memory at begin() and never grow it afterwards; frames that do not fit are reported as OVERFLOW.
+    bool setZeroAlloc(bool enable);
+    // End each capture once the enabled protocols' longest mark/space has passed instead of after the frame gap,
+    // so a key press is reported ~10ms after its last edge. Known-only modes without AC protocols.
+    bool setLowLatency(bool enable);
+    // Merge mark/space pulses shorter than glitchUs into the pulse before them, ahead of frame splitting
+    // (0: off, default). Keep it below the shortest pulse of the protocols in use.
+    bool setGlitchFilterUs(uint32_t glitchUs);
+    // Settings given by the setters above / reconfigure(). Not synchronized with a concurrent reconfigure().
+    RxConfig config() const;
+    // Replace mode, protocols and split parameters. Before begin() this is the same as calling the setters.
+    // While running it may be called from any task: the new set is resolved in the caller's task and taken
+    // over between captures, so every frame is split and decoded entirely with the old or the new settings.
+    // Pin, T, RMT buffers and the RMT idle threshold (setLowLatency) stay as begin() set them.
+    bool reconfigure(const RxConfig &config);
 
     bool poll(esp32ir::RxResult &out);
+    // Block until a result is available or timeoutTicks pass (portMAX_DELAY: no timeout). Call from a task.
+    bool poll(esp32ir::RxResult &out, TickType_t timeoutTicks);
+    // Subscribe to results (all, or only those of `protocol`; RAW also receives OVERFLOW). Handlers run in the
+    // decode task when useDecodeTask() is set (results then bypass poll), otherwise inside poll() before it returns.
+    bool onReceive(RxHandler handler, void *user = nullptr);
+    bool onReceive(esp32ir::Protocol protocol, RxHandler handler, void *user = nullptr);
+    bool clearReceiveHandlers();
+    RxDeliveryLatency deliveryLatency() const;
+    void resetDeliveryLatency();
+    // Lock-free snapshot of the per-frame latency histograms (RxResult::timing); safe from any task.
+    RxLatencyHistogram latencyHistogram() const;
+    void resetLatencyHistogram();
+    // Lock-free snapshot of the runtime counters; safe from any task. resetStats() also clears lossCounters()
+    // and droppedResultCount(), which stats() includes.
+    RxStats stats() const;
+    void resetStats();
     // Decode given ITPS frames using current protocol settings (can be used with external data sources).
-    bool decode(const esp32ir::ITPSBuffer &buf, esp32ir::RxResult &out, bool overflowed = false);
+    // What follows the decoded frame is read with decodeNext(); unlike earlier versions, poll() does not return it.
+    bool decode(const esp32ir::ITPSView &buf, esp32ir::RxResult &out, bool overflowed = false);
+    // Decode what followed the frame of the last decode()/decodeNext() (repeat codes, the next press); false when
+    // nothing is left. The remainder is kept in the receiver, apart from received frames, until the next decode().
+    bool decodeNext(esp32ir::RxResult &out);
+    // Number of times poll()/decode() had to grow heap storage since begin() (RX working memory and the caller's RxResult).
+    uint32_t heapAllocCount() const;
+    // RMT receive buffers (count 1..32, symbols each) and RX event queue depth.
+    bool setRxBufferCount(uint8_t count);
+    bool setRxBufferSymbols(size_t symbols);
+    bool setEventQueueDepth(uint16_t depth);
+    // RX working memory in RMT symbols (0: setRxBufferSymbols). With partial RX a frame can span several RMT
+    // buffers; under setZeroAlloc this bounds the longest frame.
+    bool setArenaSymbols(size_t symbols);
+    bool setOverflowPolicy(RxOverflowPolicy policy);
+    RxLossCounters lossCounters() const;
+    void resetLossCounters();
+    // Convert and decode in a dedicated FreeRTOS task; poll() then only pops finished results (core < 0: unpinned).
+    bool useDecodeTask(int core = -1, uint8_t priority = 5, uint32_t stackBytes = 4096);
+    // Depth of the result queue between the decode task and poll().
+    bool setResultQueueDepth(uint16_t depth);
+    // Results discarded because the result queue was full (decode task mode).
+    uint32_t droppedResultCount() const;
+
+    // lossCounters(); written by the RX ISR (relaxed fetch_add), read and reset from any task
+    struct LossCounters
+    {
+      std::atomic<uint32_t> droppedOldest{0};
+      std::atomic<uint32_t> droppedNewest{0};
+      std::atomic<uint32_t> countedOnly{0};
+      std::atomic<uint32_t> bufferStarved{0};
+    };
 
     struct RxCallbackContext
     {
-      QueueHandle_t queue;
-      volatile bool *overflowFlag;
-      rmt_symbol_word_t *buffers[2];
+      RxEventRing *events;
+      SemaphoreHandle_t wake; // given after each queued event when a decode task waits on it
+      std::atomic<bool> *overflowFlag;
+      rmt_symbol_word_t *buffers; // bufferCount contiguous buffers of bufferLenSymbols each
+      uint8_t bufferCount;
       size_t bufferLenSymbols;
-      volatile uint8_t *pendingMask;
+      // Bit i set: buffer i holds a queued capture. Set by the ISR before the event is published, cleared by
+      // the consumer (release) once the symbols are converted, so the ISR (acquire) never reuses a buffer early.
+      std::atomic<uint32_t> *pendingMask;
+      RxOverflowPolicy overflowPolicy;
+      LossCounters *loss;
       const rmt_receive_config_t *rxConfig;
       rmt_channel_handle_t channel;
-      volatile bool *needRestart;
+      std::atomic<bool> *needRestart;
+      std::atomic<int> *armedIndex; // buffer the RMT is filling (partial RX copies chunks out of it)
+      int64_t *eventUs;             // per buffer: when its event was queued (published with the event)
     };
 
   private:
+    friend class ReceiverGroup;
     int rxPin_{-1};
     bool invertInput_{false};
     uint16_t quantizeT_{10};
-    bool useRawOnly_{false};
-    bool useRawPlusKnown_{false};
-    bool useKnownNoAC_{false};
-    uint32_t frameGapUs_{0};
-    uint32_t hardGapUs_{0};
-    uint32_t minFrameUs_{0};
-    uint32_t maxFrameUs_{0};
-    uint16_t minEdges_{0};
-    uint16_t frameCountMax_{0};
-    RxSplitPolicy splitPolicy_{RxSplitPolicy::DROP_GAP};
-    bool splitPolicySet_{false};
-    // Effective params resolved at begin (spec: merge defaults/recommendations at begin)
-    uint32_t effFrameGapUs_{0};
-    uint32_t effHardGapUs_{0};
-    uint32_t effMinFrameUs_{0};
-    uint32_t effMaxFrameUs_{0};
-    uint16_t effMinEdges_{0};
-    uint16_t effFrameCountMax_{0};
-    RxSplitPolicy effSplitPolicy_{RxSplitPolicy::DROP_GAP};
+    RxConfig config_; // as given to the setters / reconfigure()
+    bool lowLatency_{false};
     bool begun_{false};
-    std::vector<esp32ir::Protocol> protocols_;
+    // Header dispatch: each route is a first mark/space window and the protocols (bits over routeProtocols,
+    // in try order) whose decoders can accept a frame starting inside it.
+    struct HeaderRoute
+    {
+      uint32_t markLo;
+      uint32_t markHi;
+      uint32_t spaceLo;
+      uint32_t spaceHi;
+      bool balanced; // Manchester leader: space within 40% of the mark, no absolute window
+      uint32_t mask;
+    };
+    // What the decode path runs with: a config resolved against the protocols' recommendations.
+    struct ActiveConfig : RxConfig
+    {
+      RxParamPreset params{}; // effective split parameters
+      std::vector<HeaderRoute> routes;
+      std::vector<esp32ir::Protocol> routeProtocols;
+    };
+    // Double buffer: the consumer of rxEvents_ reads configs_[activeConfig_]. A running reconfigure() resolves
+    // into the other slot, and the consumer switches over once no capture is in the arena (applyPendingConfig).
+    std::array<ActiveConfig, 2> configs_;
+    std::atomic<uint8_t> activeConfig_{0};
+    std::atomic<uint8_t> configState_{0}; // idle / being written / ready / being applied
+    bool configResolved_{false};          // active slot matches config_ (for decode() before begin())
+    const ActiveConfig &live() const { return configs_[activeConfig_.load(std::memory_order_relaxed)]; }
+    void resolveConfig(const RxConfig &config, ActiveConfig &out) const;
+    void applyPendingConfig();
     rmt_channel_handle_t rxChannel_{nullptr};
-    QueueHandle_t rxQueue_{nullptr};
-    std::array<std::vector<rmt_symbol_word_t>, 2> rxBuffers_;
+    RxEventRing rxEvents_;
+    SemaphoreHandle_t rxWake_{nullptr};
+    std::vector<rmt_symbol_word_t> rxBuffers_;
+    uint8_t rxBufferCount_{2};
     size_t rxBufferSymbols_{512};
-    volatile uint8_t rxPendingMask_{0};
-    volatile bool rxNeedRestart_{false};
+    size_t arenaSymbols_{0};
+    uint16_t rxEventQueueDepth_{8};
+    RxOverflowPolicy overflowPolicy_{RxOverflowPolicy::DROP_OLDEST};
+    LossCounters rxLoss_;
+    std::atomic<uint32_t> rxPendingMask_{0};
+    std::atomic<bool> rxNeedRestart_{false};
+    std::atomic<int> rxArmedIndex_{-1};
     rmt_receive_config_t rxConfig_{};
     RxCallbackContext rxCallbackCtx_{};
-    volatile bool rxOverflowed_{false};
-    struct PendingSegment
+    std::atomic<bool> rxOverflowed_{false};
+    bool zeroAlloc_{false};
+    std::atomic<uint32_t> heapAllocCount_{0};
+    bool decodeTaskEnabled_{false};
+    int decodeTaskCore_{-1};
+    uint8_t decodeTaskPriority_{5};
+    uint32_t decodeTaskStackBytes_{4096};
+    uint16_t resultQueueDepth_{8};
+    TaskHandle_t decodeTask_{nullptr};
+    SemaphoreHandle_t decodeLock_{nullptr}; // guards the arena between the decode task and decode()
+    esp32ir::ITPSBuffer decodeRest_;        // undecoded remainder of the decode() input (never in the RX pool)
+    size_t decodeRestPos_{0};               // entries of decodeRest_ already handed to decodeNext()
+    SemaphoreHandle_t decodeTaskDone_{nullptr};
+    std::atomic<bool> decodeTaskStop_{false};
+    std::atomic<uint32_t> droppedResults_{0};
+    esp32ir::SpscRing<esp32ir::RxResult> results_;
+    SemaphoreHandle_t resultReady_{nullptr}; // given by the decode task after each published result
+    struct Subscriber
+    {
+      RxHandler handler;
+      void *user;
+      bool filtered;
+      esp32ir::Protocol protocol;
+    };
+    std::vector<Subscriber> subscribers_;
+    int64_t wakeUs_{0}; // when the consumer of rxEvents_ last woke on rxWake_ (0: not woken, no latency sample)
+    std::atomic<uint32_t> latencyLastUs_{0};
+    std::atomic<uint32_t> latencyMaxUs_{0};
+    std::atomic<uint32_t> latencySamples_{0};
+    std::array<std::atomic<uint32_t>, RxLatencyHistogram::kBuckets> histQueued_{};
+    std::array<std::atomic<uint32_t>, RxLatencyHistogram::kBuckets> histDecode_{};
+    // stats(); only the consumer of rxEvents_ (poll() or the decode task) writes them
+    struct StatCounters
+    {
+      std::atomic<uint32_t> rmtEvents{0};
+      std::atomic<uint32_t> symbols{0};
+      std::atomic<uint32_t> framesSplit{0};
+      std::atomic<uint32_t> framesNoise{0};
+      std::atomic<uint32_t> glitches{0};
+      std::atomic<uint32_t> decodeMisses{0};
+      std::atomic<uint32_t> truncations{0};
+      std::atomic<uint32_t> overflows{0};
+      std::atomic<uint32_t> restarts{0};
+      std::array<std::atomic<uint32_t>, RxStats::kProtocols> decoded{};
+      std::array<std::atomic<uint32_t>, RxStats::kProtocols> decodeCycles{};
+    };
+    StatCounters stats_;
+    std::vector<int64_t> rxEventUs_; // per RMT buffer: ISR stamp of the event queued in it
+    esp32ir::RxResult droppedResult_;
+    // Frame waiting to be decoded; data lives in RxArena::pool (ITPS entries) or RxArena::pulses (pulse mode).
+    struct FrameSpan
+    {
+      uint32_t offset;
+      uint16_t len;
+      bool overflowed;
+      uint32_t startUs; // first/last edge, us after the capture's first mark
+      uint32_t endUs;
+    };
+    // RX working memory, reused across polls. With zeroAlloc_ the capacities are fixed at begin().
+    // Known-only modes never hand raw ITPS to the caller, so frames are kept as pulses straight from the
+    // RMT ticks and ITPS is only rebuilt for OVERFLOW results.
+    bool pulseMode_{false};
+    struct RxArena
+    {
+      std::vector<int8_t> pool;          // ITPS frame data referenced by spans
+      std::vector<esp32ir::Pulse> pulses; // pulse-mode frame data referenced by spans
+      std::vector<esp32ir::Pulse> pulseScratch; // pulses of an ITPS frame being decoded
+      size_t poolUsed{0};                 // entries (or pulses) in use
+      std::vector<FrameSpan> spans;       // pending frames (ring)
+      size_t spanHead{0};
+      size_t spanCount{0};
+      // Capture continued by the next RMT event (partial RX): the splitter resumes from split, and the frame
+      // being built stays at poolUsed (framePulses/lastPulseIndex: pulse-mode sink position).
+      bool streaming{false};
+      esp32ir::FrameSplitState split;
+      size_t framePulses{0};
+      size_t lastPulseIndex{0};
+      // Timeline of pending spans: capture's first mark and ISR stamp of the event being decoded.
+      int64_t originUs{0};
+      int64_t eventUs{0};
+    };
+    RxArena ownArena_;
+    RxArena *arena_{&ownArena_}; // ownArena_, or the shared arena of the ReceiverGroup this receiver is in
+    // ReceiverGroup membership: results are tagged with source_, and the RX ISR gives groupWake_ instead of rxWake_.
+    ReceiverGroup *group_{nullptr};
+    uint8_t source_{0};
+    SemaphoreHandle_t groupWake_{nullptr};
+    // ISR stamp of the oldest capture in rxEvents_ (a hint for the group's fan-in order).
+    bool peekEventUs(int64_t &us) const;
+    // Empty the arena and grow it to this receiver's needs (a shared arena ends up sized for its largest member).
+    void setupArena();
+    // Grow only: storage for pulseMode_ and the live config's frameCountMax.
+    void growArena();
+    size_t heapBytes(const esp32ir::RxResult &out) const;
+    bool reservePool(size_t len);
+    // Queue a pending frame; front: decode it next (the rest of a received frame that was just decoded; never
+    // for decode() input, whose rest stays out of the queue).
+    bool pushSpan(const FrameSpan &span, bool front = false);
+    bool pollFrame(esp32ir::RxResult &out);
+    bool pollOnce(esp32ir::RxResult &out);
+    // Hand a result of the decode task over to out (poll side); fixed storage on either side is copied into.
+    void takeResult(esp32ir::RxResult &out, esp32ir::RxResult &slot);
+    // Record delivery latency and call the matching handlers.
+    void deliver(const esp32ir::RxResult &out);
+    bool processEvent(const rmt_rx_done_event_data_t &ev, esp32ir::RxResult &out);
+    rmt_symbol_word_t *rxBuffer(size_t index);
+    void releaseEventRing();
+    // Consumer side of rxEvents_: next queued capture as an RMT event pointing into rxBuffers_.
+    bool takeEvent(rmt_rx_done_event_data_t &ev);
+    bool startDecodeTask();
+    void stopDecodeTask();
+    void runDecodeTask();
+    static void decodeTaskEntry(void *arg);
+    // Decode the oldest pending span and stamp out.timing.
+    bool decodePendingSpan(esp32ir::RxResult &out);
+    bool decodeSpan(const FrameSpan &span, esp32ir::RxResult &out);
+    bool decodeFrame(const esp32ir::ITPSView &buf, const FrameSpan *origin, esp32ir::RxResult &out, bool overflowed);
+    bool decodePulses(const esp32ir::PulseView &pulses, const esp32ir::ITPSView *buf, const FrameSpan *origin, esp32ir::RxResult &out);
+  };
+
+  // Several Receivers (one per RX pin) fanned into one result stream. Members keep their own RMT buffers and
+  // event ring, but convert and decode in one shared arena, so decode memory does not grow with the pin count.
+  // Results come out in the order the members' RX ISRs queued the captures and carry the member index in
+  // RxResult::source. Poll the group, not its members.
+  class ReceiverGroup
+  {
+  public:
+    static constexpr size_t kMaxSources = 8; // RMT RX channels of the largest ESP32 target
+
+    ReceiverGroup() = default;
+    ReceiverGroup(const ReceiverGroup &) = delete;
+    ReceiverGroup &operator=(const ReceiverGroup &) = delete;
+    ~ReceiverGroup();
+
+    // Add a configured receiver before begin(); results from it carry source = its add() order (0, 1, ...).
+    // Receivers using useDecodeTask(), already begun, or in another group are rejected.
+    bool add(Receiver &rx);
+    size_t size() const { return members_.size(); }
+    // Begin every member (all or none) / end them.
+    bool begin();
+    void end();
+
+    bool poll(esp32ir::RxResult &out);
+    // Block until a member has a result or timeoutTicks pass (portMAX_DELAY: no timeout). Call from a task.
+    bool poll(esp32ir::RxResult &out, TickType_t timeoutTicks);
+
+  private:
+    bool pollOnce(esp32ir::RxResult &out);
+
+    std::vector<Receiver *> members_;
+    Receiver::RxArena arena_;
+    esp32ir::RxFanIn fanIn_;
+    SemaphoreHandle_t wake_{nullptr}; // given by every member's RX ISR
+    int64_t wakeUs_{0};               // when a blocking poll last woke on wake_ (members' deliveryLatency)
+    bool begun_{false};
+  };
+
+  // Key events: one press per key instead of one result per repeat frame.
+  enum class KeyEventType : uint8_t
+  {
+    PRESS,
+    HOLD,
+    RELEASE,
+  };
+
+  struct KeyEvent
+  {
+    static constexpr size_t kMaxCodeBytes = 12; // longest non-AC message (Samsung36)
+
+    esp32ir::KeyEventType type;
+    esp32ir::Protocol protocol;
+    uint8_t source;      // RxResult::source of the key's frames
+    uint16_t count;      // frames of the key so far, repeat codes and copies included (PRESS: 1)
+    uint32_t durationUs; // first edge of the press to the end of the key's latest frame
+    int64_t timeUs;      // end of the key's latest frame (esp_timer_get_time() clock)
+    uint8_t codeLength;
+    uint8_t code[kMaxCodeBytes]; // message bytes of the press (see "Protocol messageBytes layouts")
+
+    // Copy the code into its payload struct (e.g. payload::NEC); false if the size does not match.
+    template <typename Payload>
+    bool payload(Payload &out) const
+    {
+      if (codeLength != sizeof(Payload))
+      {
+        return false;
+      }
+      memcpy(&out, code, sizeof(Payload));
+      return true;
+    }
+  };
+
+  // Turns decoded results into PRESS / HOLD / RELEASE events, one key per protocol and source. A frame that
+  // starts within the repeat window of its key's previous frame continues the key: NEC/Denon repeat codes
+  // (reported with the code of their press), SONY's repeated copies and resent frames. RC5/RC6 toggle changes
+  // and a different code start a new press. Not synchronized: feed and read from one task.
+  class KeyTracker
+  {
+  public:
+    static constexpr size_t kMaxKeys = 4;    // keys down at once; a new one releases the longest idle
+    static constexpr size_t kQueueDepth = 8; // events waiting for next()
+
+    // Gap (end of a frame to the start of the next) that still continues a key; a key with no frame for
+    // this long is released. Default 120ms (NEC repeats every 108ms, SONY every 45ms, RC5 every 114ms).
+    bool setRepeatWindowUs(uint32_t windowUs);
+    // HOLD every holdIntervalUs while a key stays down, the first one holdIntervalUs after the press
+    // (default 250ms; 0: on every repeat frame).
+    bool setHoldIntervalUs(uint32_t holdIntervalUs);
+
+    // Track one result (from poll(), onReceive() or a ReceiverGroup). Returns false if it was ignored: not
+    // DECODED, AC, or a repeat code without a held key.
+    bool feed(const esp32ir::RxResult &result);
+    // Next queued event, then releases of keys idle for the repeat window at nowUs.
+    bool next(esp32ir::KeyEvent &out, int64_t nowUs);
+    bool next(esp32ir::KeyEvent &out);
+    // Feed everything the receiver/group has ready, then return the next event.
+    bool poll(esp32ir::Receiver &rx, esp32ir::KeyEvent &out);
+    bool poll(esp32ir::ReceiverGroup &group, esp32ir::KeyEvent &out);
+    // Forget held keys and queued events (no RELEASE).
+    void reset();
+    // Events lost because kQueueDepth were already waiting.
+    uint32_t droppedEventCount() const { return droppedEvents_; }
+
+  private:
+    struct Key
     {
-      esp32ir::ITPSBuffer raw;
-      bool overflowed{false};
+      bool down;
+      esp32ir::Protocol protocol;
+      uint8_t source;
+      uint16_t count;
+      int64_t pressUs;    // first edge of the press
+      int64_t lastUs;     // end of the latest frame
+      int64_t lastHoldUs; // press or last HOLD
+      uint8_t codeLength;
+      uint8_t code[KeyEvent::kMaxCodeBytes];
     };
-    std::deque<PendingSegment> pendingSegments_;
+
+    void push(const Key &key, esp32ir::KeyEventType type);
+    bool pop(esp32ir::KeyEvent &out);
+
+    uint32_t windowUs_{120000};
+    uint32_t holdIntervalUs_{250000};
+    std::array<Key, kMaxKeys> keys_{};
+    std::array<esp32ir::KeyEvent, kQueueDepth> queue_{};
+    size_t queueHead_{0};
+    size_t queueCount_{0};
+    uint32_t droppedEvents_{0};
+    esp32ir::RxResult result_{}; // reused by poll() so its storage is not reallocated per frame
   };
 
   // Transmitter
@@ -626,11 +1330,16 @@ namespace esp32ir
     bool setCarrierHz(uint32_t hz);
     bool setDutyPercent(uint8_t dutyPercent);
     bool setGapUs(uint32_t gapUs);
+    // Fix the TX working memory at begin() to frames of up to `symbols` RMT symbols (0: grow as needed, the
+    // default). Sends then never allocate; a frame that does not fit fails instead.
+    bool setTxBufferSymbols(size_t symbols);
 
     bool begin();
     void end();
 
-    bool send(const esp32ir::ITPSBuffer &itps);
+    bool send(const esp32ir::ITPSView &itps);
+    // Compact ITPS is sent straight from its packed entries (no unpacked copy).
+    bool send(const esp32ir::CompactITPSView &itps);
     bool send(const esp32ir::ProtocolMessage &message);
 
     // Protocol-specific send helpers (struct + args where applicable; AC is struct only)
@@ -684,8 +1393,19 @@ namespace esp32ir
     bool begun_{false};
     rmt_channel_handle_t txChannel_{nullptr};
     rmt_encoder_handle_t txEncoder_{nullptr};
-
-    bool sendWithGap(const esp32ir::ITPSBuffer &itps, uint32_t recommendedGapUs);
+    // Working memory reused by every send (message bits, encoded frame, RMT symbols).
+    size_t txBufferSymbols_{0};
+    std::vector<uint8_t> txBytes_;
+    esp32ir::ITPSBuffer txFrame_;
+    std::vector<int8_t> txFrameEntries_;
+    esp32ir::ITPSFrame txFrameSlot_{};
+    std::vector<rmt_symbol_word_t> txItems_;
+
+    bool sendWithGap(const esp32ir::ITPSView &itps, uint32_t recommendedGapUs);
+    // Append the trailing gap to txItems_, transmit and wait for completion.
+    bool transmitItems(uint64_t totalUs, uint32_t gapUs);
+    // Send a frame encoded into txFrame_ by a protocol helper.
+    bool sendEncoded(const esp32ir::ITPSBuffer &frame, esp32ir::Protocol proto);
     uint32_t recommendedGapUs(esp32ir::Protocol proto) const;
   };
 
@@ -706,6 +1426,41 @@ namespace esp32ir
   bool decodeToshiba(const esp32ir::RxResult &in, esp32ir::payload::Toshiba &out);
   bool decodeMitsubishi(const esp32ir::RxResult &in, esp32ir::payload::Mitsubishi &out);
   bool decodeHitachi(const esp32ir::RxResult &in, esp32ir::payload::Hitachi &out);
+  // Same decoders on ITPS frames without a RxResult (an ITPSBuffer, or an ITPSView over e.g. flash).
+  bool decodeNEC(const esp32ir::ITPSView &raw, esp32ir::payload::NEC &out);
+  bool decodeSONY(const esp32ir::ITPSView &raw, esp32ir::payload::SONY &out);
+  bool decodeAEHA(const esp32ir::ITPSView &raw, esp32ir::payload::AEHA &out);
+  bool decodePanasonic(const esp32ir::ITPSView &raw, esp32ir::payload::Panasonic &out);
+  bool decodeJVC(const esp32ir::ITPSView &raw, esp32ir::payload::JVC &out);
+  bool decodeSamsung(const esp32ir::ITPSView &raw, esp32ir::payload::Samsung &out);
+  bool decodeSamsung36(const esp32ir::ITPSView &raw, esp32ir::payload::Samsung36 &out);
+  bool decodeLG(const esp32ir::ITPSView &raw, esp32ir::payload::LG &out);
+  bool decodeDenon(const esp32ir::ITPSView &raw, esp32ir::payload::Denon &out);
+  bool decodeRC5(const esp32ir::ITPSView &raw, esp32ir::payload::RC5 &out);
+  bool decodeRC6(const esp32ir::ITPSView &raw, esp32ir::payload::RC6 &out);
+  bool decodeApple(const esp32ir::ITPSView &raw, esp32ir::payload::Apple &out);
+  bool decodePioneer(const esp32ir::ITPSView &raw, esp32ir::payload::Pioneer &out);
+  bool decodeToshiba(const esp32ir::ITPSView &raw, esp32ir::payload::Toshiba &out);
+  bool decodeMitsubishi(const esp32ir::ITPSView &raw, esp32ir::payload::Mitsubishi &out);
+  bool decodeHitachi(const esp32ir::ITPSView &raw, esp32ir::payload::Hitachi &out);
+  // Same decoders on pulses you already have (see makePulseView). These look only at the pulses, so a
+  // RxResult that is already DECODED needs the RxResult overloads above.
+  bool decodeNEC(const esp32ir::PulseView &pulses, esp32ir::payload::NEC &out);
+  bool decodeSONY(const esp32ir::PulseView &pulses, esp32ir::payload::SONY &out);
+  bool decodeAEHA(const esp32ir::PulseView &pulses, esp32ir::payload::AEHA &out);
+  bool decodePanasonic(const esp32ir::PulseView &pulses, esp32ir::payload::Panasonic &out);
+  bool decodeJVC(const esp32ir::PulseView &pulses, esp32ir::payload::JVC &out);
+  bool decodeSamsung(const esp32ir::PulseView &pulses, esp32ir::payload::Samsung &out);
+  bool decodeSamsung36(const esp32ir::PulseView &pulses, esp32ir::payload::Samsung36 &out);
+  bool decodeLG(const esp32ir::PulseView &pulses, esp32ir::payload::LG &out);
+  bool decodeDenon(const esp32ir::PulseView &pulses, esp32ir::payload::Denon &out);
+  bool decodeRC5(const esp32ir::PulseView &pulses, esp32ir::payload::RC5 &out);
+  bool decodeRC6(const esp32ir::PulseView &pulses, esp32ir::payload::RC6 &out);
+  bool decodeApple(const esp32ir::PulseView &pulses, esp32ir::payload::Apple &out);
+  bool decodePioneer(const esp32ir::PulseView &pulses, esp32ir::payload::Pioneer &out);
+  bool decodeToshiba(const esp32ir::PulseView &pulses, esp32ir::payload::Toshiba &out);
+  bool decodeMitsubishi(const esp32ir::PulseView &pulses, esp32ir::payload::Mitsubishi &out);
+  bool decodeHitachi(const esp32ir::PulseView &pulses, esp32ir::payload::Hitachi &out);
   // AC common API
   bool decodeAC(const esp32ir::RxResult &in, const esp32ir::ac::Capabilities &capabilities, esp32ir::ac::DeviceState &out);
   bool decodeDaikinAC(const esp32ir::RxResult &in, const esp32ir::ac::Capabilities &capabilities, esp32ir::ac::DeviceState &out);
@@ -0,0 +1,38 @@
+#pragma once
+
+// Progress of a FrameSplitter (core/frame_splitter.h) through one capture.
+// Kept outside the splitter so a capture delivered as several partial RMT events can resume where the
+// previous event stopped. Default-constructed: at the start of a capture.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp32ir
+{
+    struct FrameSplitState
+    {
+        // glitch filter
+        bool heldMark{false};   // level of the pulse held back until its length is known
+        uint32_t heldCounts{0}; // its length in T units (0: none)
+        bool passedMark{false}; // level of the last pulse passed on (space: idle line)
+        uint32_t glitches{0};   // pulses merged into their neighbours
+        // run merging
+        bool started{false};
+        bool runMark{true};
+        uint32_t runCounts{0};
+        // gap splitting
+        size_t currentLen{0}; // entries of the frame being built
+        uint32_t currentTimeUs{0};
+        uint32_t frameUs{0};
+        uint32_t spaceRunUs{0};
+        size_t spaceRunStartIndex{0};
+        uint32_t spaceRunStartFrameUs{0};
+        uint16_t framesFound{0};
+        uint16_t framesRejected{0}; // dropped as noise
+        // capture timeline in us from its first mark
+        uint32_t inputUs{0};       // durations pushed so far
+        uint32_t entryUs{0};       // start of the next entry
+        uint32_t frameStartUs{0};  // first edge of the frame being built
+        uint32_t lastMarkEndUs{0}; // its last edge so far
+    };
+} // namespace esp32ir
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "ESP32IRPulseCodec.h"
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp32ir
+{
+    // Single-pass mark/space -> ITPS frame splitter.
+    // Fuses an optional glitch filter, quantized run merging (±127 chunks), leading-space skipping,
+    // gap/hard-gap/max-frame splitting and noise filtering; frame entries are written straight into the sink,
+    // nothing is buffered here.
+    //
+    // Sink requirements:
+    //   bool put(size_t index, int8_t v);  // store entry `index` of the frame being built (false: no room)
+    //   bool commit(size_t len, uint32_t startUs, uint32_t endUs);
+    //                                      // accept entries [0, len) as a frame whose first/last edge lie startUs/endUs
+    //                                      // after the first mark of the capture (false: could not queue)
+    // A frame that is dropped as noise is simply overwritten by the next one.
+    template <typename Sink>
+    class FrameSplitter
+    {
+    public:
+        // resume: state() of a splitter that stopped mid-capture (partial RMT events), so the capture splits as one.
+        // glitchCounts: pulses shorter than this (T units) take the level of the pulse before them (0: no filter).
+        FrameSplitter(const esp32ir::RxParamPreset &params, uint16_t T_us, Sink &sink, const esp32ir::FrameSplitState &resume = {},
+                      uint32_t glitchCounts = 0)
+            : params_(params), T_us_(T_us), sink_(sink), s_(resume), glitchCounts_(glitchCounts)
+        {
+            // Allow a small tolerance when deciding gaps to cope with measurement jitter.
+            gapToleranceUs_ = params_.frameGapUs ? std::max<uint32_t>(T_us_, params_.frameGapUs / 20) : T_us_;
+            hardGapToleranceUs_ = params_.hardGapUs ? std::max<uint32_t>(T_us_, params_.hardGapUs / 20) : T_us_;
+        }
+
+        // Feed one mark/space duration in T units (RMT ticks at 1/T resolution). Zero is ignored.
+        void push(bool mark, uint32_t counts)
+        {
+            if (glitchCounts_ == 0)
+            {
+                feed(mark, counts);
+                return;
+            }
+            // A pulse is only judged once the next level starts, so one pulse is held back.
+            if (counts == 0)
+            {
+                return;
+            }
+            if (s_.heldCounts > 0 && mark != s_.heldMark)
+            {
+                releaseHeld();
+            }
+            s_.heldMark = mark;
+            s_.heldCounts += counts;
+        }
+
+        // Flush the pending run and the last frame.
+        void finish()
+        {
+            if (s_.heldCounts > 0)
+            {
+                releaseHeld();
+            }
+            if (!s_.started)
+            {
+                return;
+            }
+            endRun();
+            bool allowShortFinal = (s_.currentLen < params_.minEdges) && (s_.currentTimeUs >= params_.minFrameUs);
+            flush(allowShortFinal);
+            s_.started = false;
+        }
+
+        bool overflowed() const { return overflowed_; }
+        uint16_t frameCount() const { return s_.framesFound; }
+        uint16_t rejectedCount() const { return s_.framesRejected; }
+        const esp32ir::FrameSplitState &state() const { return s_; }
+
+    private:
+        // A short pulse merges into the one before it: a spike inside a mark or space disappears, and a noise
+        // burst on the idle line stays idle instead of starting a frame.
+        void releaseHeld()
+        {
+            bool mark = s_.heldMark;
+            if (s_.heldCounts < glitchCounts_ && mark != s_.passedMark)
+            {
+                mark = s_.passedMark;
+                ++s_.glitches;
+            }
+            feed(mark, s_.heldCounts);
+            s_.passedMark = mark;
+            s_.heldCounts = 0;
+        }
+
+        void feed(bool mark, uint32_t counts)
+        {
+            if (counts == 0)
+            {
+                return;
+            }
+            if (!s_.started)
+            {
+                if (!mark)
+                {
+                    return; // leading spaces carry no information
+                }
+                s_.started = true;
+                s_.runMark = true;
+            }
+            else if (mark != s_.runMark)
+            {
+                endRun();
+                s_.runMark = mark;
+            }
+            s_.inputUs += counts * T_us_;
+            // Same-level durations merge; chunks of 127 are final once more than 127 counts are pending.
+            s_.runCounts += counts;
+            while (s_.runCounts > 127)
+            {
+                entry(s_.runMark ? 127 : -127);
+                s_.runCounts -= 127;
+            }
+        }
+
+        void endRun()
+        {
+            if (s_.runCounts > 0)
+            {
+                entry(static_cast<int>(s_.runMark ? s_.runCounts : -static_cast<int>(s_.runCounts)));
+                s_.runCounts = 0;
+            }
+        }
+
+        void append(int v, uint32_t durUs, uint32_t atUs)
+        {
+            if (!sink_.put(s_.currentLen, static_cast<int8_t>(v)))
+            {
+                overflowed_ = true;
+                return;
+            }
+            if (s_.currentLen == 0)
+            {
+                s_.frameStartUs = atUs;
+            }
+            if (v > 0)
+            {
+                s_.lastMarkEndUs = atUs + durUs;
+            }
+            ++s_.currentLen;
+            s_.frameUs += durUs;
+        }
+
+        void dropSpaceRun()
+        {
+            // drop the accumulated gap from the frame (s_.spaceRunStartIndex always belongs to the current run)
+            if (s_.currentLen >= s_.spaceRunStartIndex)
+            {
+                s_.currentLen = s_.spaceRunStartIndex;
+                s_.frameUs = s_.spaceRunStartFrameUs;
+            }
+            if (s_.currentTimeUs > s_.spaceRunUs)
+            {
+                s_.currentTimeUs -= s_.spaceRunUs;
+            }
+            else
+            {
+                s_.currentTimeUs = 0;
+            }
+        }
+
+        void flush(bool allowShort)
+        {
+            if (s_.currentLen == 0)
+            {
+                return;
+            }
+            // Frames below minEdges/minFrameUs are noise; not an error.
+            if (allowShort || (s_.currentLen >= params_.minEdges && s_.frameUs >= params_.minFrameUs))
+            {
+                ++s_.framesFound;
+                if (params_.frameCountMax > 0 && s_.framesFound > params_.frameCountMax)
+                {
+                    overflowed_ = true;
+                }
+                if (!sink_.commit(s_.currentLen, s_.frameStartUs, s_.lastMarkEndUs))
+                {
+                    overflowed_ = true;
+                }
+            }
+            else
+            {
+                ++s_.framesRejected;
+            }
+            s_.currentLen = 0;
+            s_.currentTimeUs = 0;
+            s_.frameUs = 0;
+        }
+
+        // One normalized ITPS entry.
+        void entry(int v)
+        {
+            uint32_t durUs = static_cast<uint32_t>((v < 0 ? -v : v) * T_us_);
+            bool isSpace = v < 0;
+            const uint32_t atUs = s_.entryUs;
+            s_.entryUs += durUs;
+
+            if (isSpace)
+            {
+                if (s_.spaceRunUs == 0)
+                {
+                    s_.spaceRunStartIndex = s_.currentLen;
+                    s_.spaceRunStartFrameUs = s_.frameUs;
+                }
+                s_.spaceRunUs += durUs;
+            }
+            else
+            {
+                s_.spaceRunUs = 0;
+            }
+
+            bool forceSplit = false;
+            if (isSpace && params_.hardGapUs > 0 && (s_.spaceRunUs + hardGapToleranceUs_) >= params_.hardGapUs)
+            {
+                forceSplit = true;
+            }
+            else if (isSpace && params_.maxFrameUs > 0 && (s_.currentTimeUs + durUs) > params_.maxFrameUs && s_.currentLen > 0)
+            {
+                forceSplit = true;
+            }
+
+            if (forceSplit && s_.currentLen > 0)
+            {
+                if (params_.splitPolicy == esp32ir::RxSplitPolicy::KEEP_GAP_IN_FRAME)
+                {
+                    append(v, durUs, atUs);
+                    s_.currentTimeUs += durUs;
+                }
+                else
+                {
+                    dropSpaceRun();
+                }
+                flush(/*allowShort=*/true);
+                s_.spaceRunUs = 0;
+                return;
+            }
+
+            if (s_.currentLen == 0 && isSpace)
+            {
+                s_.spaceRunUs = 0;
+                return;
+            }
+            append(v, durUs, atUs);
+            s_.currentTimeUs += durUs;
+
+            if (isSpace && params_.frameGapUs > 0 && (s_.spaceRunUs + gapToleranceUs_) >= params_.frameGapUs)
+            {
+                if (params_.splitPolicy != esp32ir::RxSplitPolicy::KEEP_GAP_IN_FRAME)
+                {
+                    dropSpaceRun();
+                }
+                flush(/*allowShort=*/true);
+                s_.spaceRunUs = 0;
+            }
+        }
+
+        esp32ir::RxParamPreset params_;
+        uint16_t T_us_;
+        Sink &sink_;
+        uint32_t gapToleranceUs_{0};
+        uint32_t hardGapToleranceUs_{0};
+        esp32ir::FrameSplitState s_;
+        uint32_t glitchCounts_;
+        bool overflowed_{false};
+    };
+} // namespace esp32ir
@@ -1,53 +1,354 @@
 #include "ESP32IRPulseCodec.h"
+#include <algorithm>
 
 namespace esp32ir
 {
 
-  void ITPSBuffer::clear() { frames_.clear(); }
+  const esp32ir::ITPSFrame &ITPSView::frame(uint16_t i) const
+  {
+    static const esp32ir::ITPSFrame kEmptyFrame{0, 0, nullptr, 0};
+    if (frames && i < count)
+    {
+      return frames[i];
+    }
+    return kEmptyFrame;
+  }
 
-  void ITPSBuffer::addFrame(const esp32ir::ITPSFrame &f)
+  uint32_t ITPSView::totalTimeUs() const
   {
+    uint32_t total = 0;
+    for (uint16_t n = 0; n < frameCount(); ++n)
+    {
+      const auto &f = frames[n];
+      if (!f.seq || f.len == 0 || f.T_us == 0)
+      {
+        continue;
+      }
+      uint32_t counts = 0;
+      for (uint16_t i = 0; i < f.len; ++i)
+      {
+        int v = f.seq[i];
+        counts += (v < 0) ? static_cast<uint32_t>(-v) : static_cast<uint32_t>(v);
+      }
+      total += counts * static_cast<uint32_t>(f.T_us);
+    }
+    return total;
+  }
+
+  ITPSBuffer::ITPSBuffer(const ITPSBuffer &other) { copyFrom(other); }
+
+  ITPSBuffer::ITPSBuffer(ITPSBuffer &&other) noexcept { *this = std::move(other); }
+
+  ITPSBuffer &ITPSBuffer::operator=(const ITPSBuffer &other)
+  {
+    if (this != &other)
+    {
+      clear();
+      copyFrom(other);
+    }
+    return *this;
+  }
+
+  ITPSBuffer &ITPSBuffer::operator=(ITPSBuffer &&other) noexcept
+  {
+    if (this == &other)
+    {
+      return *this;
+    }
+    if (fixed_ || other.fixed_)
+    {
+      // Fixed storage stays with its buffer: copy.
+      clear();
+      copyFrom(other);
+      other.clear();
+      return *this;
+    }
+    // Heap storage changes owner in place; inline storage is copied and seq moved over to our arena.
+    const int8_t *oldBase = other.entries_;
+    if (other.entries_ != other.inlineEntries_)
+    {
+      heapEntries_ = std::move(other.heapEntries_);
+      entries_ = heapEntries_.data();
+      entryCap_ = other.entryCap_;
+      other.entries_ = other.inlineEntries_;
+      other.entryCap_ = kInlineEntries;
+    }
+    else
+    {
+      std::copy(other.inlineEntries_, other.inlineEntries_ + other.used_, entries_);
+    }
+    if (other.frames_ != other.inlineFrames_)
+    {
+      heapFrames_ = std::move(other.heapFrames_);
+      frames_ = heapFrames_.data();
+      frameCap_ = other.frameCap_;
+      other.frames_ = other.inlineFrames_;
+      other.frameCap_ = kInlineFrames;
+    }
+    else
+    {
+      std::copy(other.inlineFrames_, other.inlineFrames_ + other.count_, frames_);
+    }
+    used_ = other.used_;
+    count_ = other.count_;
+    totalUs_ = other.totalUs_;
+    totalValid_ = other.totalValid_;
+    rebase(oldBase);
+    other.clear();
+    return *this;
+  }
+
+  void ITPSBuffer::copyFrom(const ITPSBuffer &other)
+  {
+    if (!growEntries(other.used_) || !growFrames(other.count_))
+    {
+      // Fixed storage too small: keep what fits (addFrame truncates and sets overflowed_).
+      assign(other.view());
+      overflowed_ = true;
+      return;
+    }
+    // One block copy of the entries and the table, with seq moved over to our own arena.
+    std::copy(other.entries_, other.entries_ + other.used_, entries_);
+    for (uint16_t i = 0; i < other.count_; ++i)
+    {
+      frames_[i] = other.frames_[i];
+      frames_[i].seq = entries_ + (other.frames_[i].seq - other.entries_);
+    }
+    used_ = other.used_;
+    count_ = other.count_;
+    totalUs_ = other.totalUs_;
+    totalValid_ = other.totalValid_;
+    overflowed_ = overflowed_ || other.overflowed_;
+  }
+
+  void ITPSBuffer::clear()
+  {
+    used_ = 0;
+    count_ = 0;
+    totalUs_ = 0;
+    totalValid_ = true;
+    overflowed_ = false;
+  }
+
+  bool ITPSBuffer::addFrame(const esp32ir::ITPSFrame &frame)
+  {
+    const esp32ir::ITPSFrame f = frame; // frame may be an entry of our own table, which growing moves
     if (!f.seq || f.len == 0 || f.T_us == 0)
+    {
+      return true;
+    }
+    // Likewise its entries may be in our own arena.
+    const bool own = f.seq >= entries_ && f.seq < entries_ + used_;
+    const size_t ownOffset = own ? static_cast<size_t>(f.seq - entries_) : 0;
+    uint16_t len = f.len;
+    if (fixed_ && used_ + len > entryCap_)
+    {
+      len = static_cast<uint16_t>(entryCap_ - used_); // keep the head of the frame
+    }
+    int8_t *seq = len > 0 ? appendFrame(f.T_us, len, f.flags) : nullptr;
+    if (!seq)
+    {
+      overflowed_ = true;
+      return false;
+    }
+    const int8_t *src = own ? entries_ + ownOffset : f.seq;
+    std::copy(src, src + len, seq);
+    if (len < f.len)
+    {
+      overflowed_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  void ITPSBuffer::assign(const esp32ir::ITPSView &view)
+  {
+    if (view.frames == frames_)
+    {
+      return; // our own view
+    }
+    clear();
+    for (uint16_t i = 0; i < view.frameCount(); ++i)
+    {
+      if (!addFrame(view.frames[i]))
+      {
+        break; // out of fixed storage
+      }
+    }
+  }
+
+  int8_t *ITPSBuffer::appendFrame(uint16_t T_us, uint16_t len, uint8_t flags)
+  {
+    if (!growEntries(used_ + len) || !growFrames(count_ + 1))
+    {
+      return nullptr;
+    }
+    int8_t *seq = entries_ + used_;
+    frames_[count_++] = {T_us, len, seq, flags};
+    used_ += len;
+    totalValid_ = false;
+    return seq;
+  }
+
+  bool ITPSBuffer::beginFrame(uint16_t T_us, uint8_t flags)
+  {
+    if (!growFrames(count_ + 1))
+    {
+      return false;
+    }
+    frames_[count_++] = {T_us, 0, entries_ + used_, flags};
+    return true;
+  }
+
+  bool ITPSBuffer::appendEntry(int8_t v)
+  {
+    if (count_ == 0 || frames_[count_ - 1].len == UINT16_MAX || !growEntries(used_ + 1))
+    {
+      return false;
+    }
+    entries_[used_++] = v;
+    ++frames_[count_ - 1].len;
+    totalValid_ = false;
+    return true;
+  }
+
+  void ITPSBuffer::reserve(uint16_t frames, uint16_t entriesPerFrame)
+  {
+    if (fixed_)
     {
       return;
     }
-    FrameStorage storage;
-    storage.data.assign(f.seq, f.seq + f.len);
-    storage.frame = f;
-    storage.frame.seq = storage.data.data();
-    frames_.push_back(std::move(storage));
+    growFrames(frames);
+    growEntries(static_cast<size_t>(frames) * entriesPerFrame);
   }
 
-  uint16_t ITPSBuffer::frameCount() const { return static_cast<uint16_t>(frames_.size()); }
+  void ITPSBuffer::useStorage(int8_t *entries, size_t entryCapacity, esp32ir::ITPSFrame *frames, uint16_t frameCapacity)
+  {
+    clear();
+    std::vector<int8_t>().swap(heapEntries_);
+    std::vector<esp32ir::ITPSFrame>().swap(heapFrames_);
+    fixed_ = entries && frames && entryCapacity > 0 && frameCapacity > 0;
+    entries_ = fixed_ ? entries : inlineEntries_;
+    entryCap_ = fixed_ ? entryCapacity : kInlineEntries;
+    frames_ = fixed_ ? frames : inlineFrames_;
+    frameCap_ = fixed_ ? frameCapacity : kInlineFrames;
+  }
+
+  bool ITPSBuffer::growEntries(size_t need)
+  {
+    if (need <= entryCap_)
+    {
+      return true;
+    }
+    if (fixed_)
+    {
+      overflowed_ = true;
+      return false;
+    }
+    const int8_t *oldBase = entries_;
+    if (entries_ == inlineEntries_)
+    {
+      heapEntries_.resize(std::max<size_t>(need, static_cast<size_t>(kInlineEntries) * 2));
+      std::copy(inlineEntries_, inlineEntries_ + used_, heapEntries_.data());
+    }
+    else
+    {
+      heapEntries_.resize(std::max(need, entryCap_ * 2));
+    }
+    entries_ = heapEntries_.data();
+    entryCap_ = heapEntries_.size();
+    rebase(oldBase);
+    return true;
+  }
+
+  bool ITPSBuffer::growFrames(uint16_t need)
+  {
+    if (need <= frameCap_)
+    {
+      return true;
+    }
+    if (fixed_)
+    {
+      overflowed_ = true;
+      return false;
+    }
+    if (frames_ == inlineFrames_)
+    {
+      heapFrames_.resize(std::max<size_t>(need, static_cast<size_t>(kInlineFrames) * 2));
+      std::copy(inlineFrames_, inlineFrames_ + count_, heapFrames_.data());
+    }
+    else
+    {
+      heapFrames_.resize(std::min<size_t>(std::max<size_t>(need, static_cast<size_t>(frameCap_) * 2), UINT16_MAX));
+    }
+    frames_ = heapFrames_.data();
+    frameCap_ = static_cast<uint16_t>(heapFrames_.size());
+    return true;
+  }
+
+  void ITPSBuffer::rebase(const int8_t *oldBase)
+  {
+    for (uint16_t i = 0; i < count_; ++i)
+    {
+      frames_[i].seq = entries_ + (frames_[i].seq - oldBase);
+    }
+  }
+
+  size_t ITPSBuffer::reservedBytes() const
+  {
+    return heapEntries_.capacity() + heapFrames_.capacity() * sizeof(esp32ir::ITPSFrame);
+  }
+
+  uint16_t ITPSBuffer::frameCount() const { return count_; }
 
   const esp32ir::ITPSFrame &ITPSBuffer::frame(uint16_t i) const
   {
     static const esp32ir::ITPSFrame kEmptyFrame{0, 0, nullptr, 0};
-    if (i < frames_.size())
+    if (i < count_)
     {
-      return frames_[i].frame;
+      return frames_[i];
     }
     return kEmptyFrame;
   }
 
   uint32_t ITPSBuffer::totalTimeUs() const
   {
-    uint32_t total = 0;
-    for (const auto &fs : frames_)
+    if (!totalValid_)
     {
-      const auto &f = fs.frame;
-      if (!f.seq || f.len == 0 || f.T_us == 0)
-      {
+      totalUs_ = view().totalTimeUs();
+      totalValid_ = true;
+    }
+    return totalUs_;
+  }
+
+  esp32ir::PulseView makePulseView(const esp32ir::ITPSView &raw, esp32ir::Pulse *storage, size_t capacity)
+  {
+    size_t n = 0;
+    const auto &f = raw.frame(0);
+    if (!storage || !f.seq || f.T_us == 0)
+    {
+      return {storage, 0};
+    }
+    for (uint16_t i = 0; i < f.len; ++i)
+    {
+      int v = f.seq[i];
+      if (v == 0)
         continue;
+      esp32ir::Pulse p{v > 0, static_cast<uint32_t>((v < 0 ? -v : v) * f.T_us)};
+      if (n > 0 && storage[n - 1].mark == p.mark)
+      {
+        storage[n - 1].us += p.us;
       }
-      for (uint16_t i = 0; i < f.len; ++i)
+      else if (n < capacity)
       {
-        int v = f.seq[i];
-        uint32_t mag = (v < 0) ? static_cast<uint32_t>(-v) : static_cast<uint32_t>(v);
-        total += mag * static_cast<uint32_t>(f.T_us);
+        storage[n++] = p;
+      }
+      else
+      {
+        break;
       }
     }
-    return total;
+    return {storage, n};
   }
 
 } // namespace esp32ir
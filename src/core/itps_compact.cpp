@@ -0,0 +1,444 @@
+#include "ESP32IRPulseCodec.h"
+#include <algorithm>
+#include <utility>
+
+namespace esp32ir
+{
+
+  namespace
+  {
+    constexpr size_t kHeaderBytes = 3;     // version, frameCount
+    constexpr size_t kFrameFixedBytes = 7; // T_us, len, flags, mode, paletteSize
+    constexpr uint8_t kVerbatim = 0;       // mode: entries stored as they are
+    constexpr uint8_t kMaxIndexBits = 4;
+    constexpr uint8_t kMaxOffsetBits = 7;
+    constexpr uint8_t kLiteralBits = 16; // escaped run length
+
+    uint16_t readU16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+    // Mode byte and palette size of a frame header agree (a verbatim frame has no palette).
+    bool validMode(const uint8_t *h)
+    {
+      const uint8_t mode = h[5];
+      const uint8_t indexBits = mode & 0x7;
+      const uint8_t paletteSize = h[6];
+      if (mode == kVerbatim)
+      {
+        return paletteSize == 0;
+      }
+      return indexBits != 0 && indexBits <= kMaxIndexBits && (mode >> 3) <= kMaxOffsetBits && paletteSize < (1u << indexBits);
+    }
+
+    void putU16(std::vector<uint8_t> &out, uint16_t v)
+    {
+      out.push_back(static_cast<uint8_t>(v & 0xFF));
+      out.push_back(static_cast<uint8_t>(v >> 8));
+    }
+
+    // Appends n-bit values LSB first.
+    class BitWriter
+    {
+    public:
+      explicit BitWriter(std::vector<uint8_t> &out) : out_(out) {}
+      void put(uint32_t v, uint8_t n)
+      {
+        for (uint8_t i = 0; i < n; ++i)
+        {
+          if (bit_ == 0)
+          {
+            out_.push_back(0);
+          }
+          if ((v >> i) & 1u)
+          {
+            out_.back() |= static_cast<uint8_t>(1u << bit_);
+          }
+          bit_ = (bit_ + 1) & 7;
+        }
+      }
+
+    private:
+      std::vector<uint8_t> &out_;
+      uint8_t bit_{0};
+    };
+
+    // Run lengths of a normalized frame (starts with a mark, every run split greedily at 127), so that the
+    // entries can be rebuilt from them exactly. False otherwise.
+    bool runLengths(const esp32ir::ITPSFrame &f, std::vector<uint32_t> &runs)
+    {
+      runs.clear();
+      if (f.seq[0] <= 0)
+      {
+        return false;
+      }
+      bool split = false; // previous entry was a full chunk of the current run
+      for (uint16_t i = 0; i < f.len; ++i)
+      {
+        const int v = f.seq[i];
+        if (v == 0 || v == -128)
+        {
+          return false;
+        }
+        const uint32_t counts = static_cast<uint32_t>(v < 0 ? -v : v);
+        const bool continues = i > 0 && (v > 0) == (f.seq[i - 1] > 0);
+        if (continues != split)
+        {
+          return false; // a run split below 127, or a full chunk that ends its run
+        }
+        if (continues)
+        {
+          runs.back() += counts;
+        }
+        else
+        {
+          runs.push_back(counts);
+        }
+        split = counts == 127;
+        if (runs.back() > UINT16_MAX)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Cluster bases of width 2^offsetBits covering the runs, most populated first (greedy from the shortest).
+    void clusterRuns(const std::vector<uint32_t> &sorted, uint8_t offsetBits, std::vector<std::pair<uint32_t, uint32_t>> &clusters)
+    {
+      clusters.clear(); // (members, base)
+      const uint32_t width = 1u << offsetBits;
+      for (size_t i = 0; i < sorted.size();)
+      {
+        const uint32_t base = sorted[i];
+        size_t j = i;
+        while (j < sorted.size() && sorted[j] < base + width)
+        {
+          ++j;
+        }
+        clusters.emplace_back(static_cast<uint32_t>(j - i), base);
+        i = j;
+      }
+      std::sort(clusters.begin(), clusters.end(), [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b)
+                { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+    }
+
+    void packFrame(const esp32ir::ITPSFrame &f, std::vector<uint8_t> &out)
+    {
+      std::vector<uint32_t> runs;
+      std::vector<std::pair<uint32_t, uint32_t>> clusters;
+      uint8_t mode = kVerbatim;
+      size_t best = f.len; // verbatim: one byte per entry
+      uint8_t bestOffsetBits = 0;
+      size_t bestPalette = 0;
+      if (runLengths(f, runs))
+      {
+        std::vector<uint32_t> sorted = runs;
+        std::sort(sorted.begin(), sorted.end());
+        for (uint8_t r = 0; r <= kMaxOffsetBits; ++r)
+        {
+          clusterRuns(sorted, r, clusters);
+          for (uint8_t b = 1; b <= kMaxIndexBits; ++b)
+          {
+            const size_t palette = std::min<size_t>(clusters.size(), (1u << b) - 1);
+            size_t covered = 0;
+            for (size_t k = 0; k < palette; ++k)
+            {
+              covered += clusters[k].first;
+            }
+            const size_t bits = covered * (b + r) + (runs.size() - covered) * (b + kLiteralBits);
+            const size_t bytes = palette * 2 + (bits + 7) / 8;
+            if (bytes < best)
+            {
+              best = bytes;
+              mode = static_cast<uint8_t>(b | (r << 3));
+              bestOffsetBits = r;
+              bestPalette = palette;
+            }
+          }
+        }
+      }
+
+      putU16(out, f.T_us);
+      putU16(out, f.len);
+      out.push_back(f.flags);
+      out.push_back(mode);
+      out.push_back(static_cast<uint8_t>(bestPalette));
+      if (mode == kVerbatim)
+      {
+        putU16(out, f.len);
+        out.insert(out.end(), reinterpret_cast<const uint8_t *>(f.seq), reinterpret_cast<const uint8_t *>(f.seq) + f.len);
+        return;
+      }
+      const uint8_t indexBits = mode & 0x7;
+      const uint32_t width = 1u << bestOffsetBits;
+      std::vector<uint32_t> sorted = runs;
+      std::sort(sorted.begin(), sorted.end());
+      clusterRuns(sorted, bestOffsetBits, clusters);
+      clusters.resize(bestPalette);
+      for (const auto &c : clusters)
+      {
+        putU16(out, static_cast<uint16_t>(c.second));
+      }
+      const size_t dataAt = out.size();
+      putU16(out, 0); // dataBytes, filled in below
+      BitWriter w(out);
+      const uint32_t escape = (1u << indexBits) - 1;
+      for (uint32_t counts : runs)
+      {
+        size_t k = 0;
+        while (k < clusters.size() && !(counts >= clusters[k].second && counts < clusters[k].second + width))
+        {
+          ++k;
+        }
+        if (k < clusters.size())
+        {
+          w.put(static_cast<uint32_t>(k), indexBits);
+          w.put(counts - clusters[k].second, bestOffsetBits);
+        }
+        else
+        {
+          w.put(escape, indexBits);
+          w.put(counts, kLiteralBits);
+        }
+      }
+      const size_t dataBytes = out.size() - dataAt - 2;
+      out[dataAt] = static_cast<uint8_t>(dataBytes & 0xFF);
+      out[dataAt + 1] = static_cast<uint8_t>(dataBytes >> 8);
+    }
+  } // namespace
+
+  bool CompactITPSView::Reader::readBits(uint8_t n, uint32_t &v)
+  {
+    if (bitPos_ + n > dataBits_)
+    {
+      return false;
+    }
+    v = 0;
+    for (uint8_t k = 0; k < n; ++k, ++bitPos_)
+    {
+      v |= static_cast<uint32_t>((data_[bitPos_ >> 3] >> (bitPos_ & 7)) & 1u) << k;
+    }
+    return true;
+  }
+
+  bool CompactITPSView::Reader::readRun(uint32_t &counts)
+  {
+    uint32_t index = 0;
+    if (!readBits(indexBits_, index))
+    {
+      return false;
+    }
+    if (index < paletteSize_)
+    {
+      uint32_t offset = 0;
+      if (!readBits(offsetBits_, offset))
+      {
+        return false;
+      }
+      counts = readU16(palette_ + index * 2) + offset;
+    }
+    else if (index != (1u << indexBits_) - 1 || !readBits(kLiteralBits, counts))
+    {
+      return false;
+    }
+    return counts > 0;
+  }
+
+  bool CompactITPSView::Reader::next(int8_t &v)
+  {
+    if (left_ == 0)
+    {
+      return false;
+    }
+    if (indexBits_ == 0)
+    {
+      uint32_t entry = 0;
+      if (!readBits(8, entry))
+      {
+        left_ = 0;
+        return false;
+      }
+      v = static_cast<int8_t>(static_cast<uint8_t>(entry));
+    }
+    else
+    {
+      // Runs alternate mark/space from a mark and are split at 127 as they are read.
+      if (runLeft_ == 0)
+      {
+        if (!readRun(runLeft_))
+        {
+          left_ = 0;
+          return false;
+        }
+        runMark_ = !runMark_;
+      }
+      const uint32_t chunk = runLeft_ > 127 ? 127 : runLeft_;
+      runLeft_ -= chunk;
+      v = static_cast<int8_t>(runMark_ ? static_cast<int>(chunk) : -static_cast<int>(chunk));
+    }
+    --left_;
+    return true;
+  }
+
+  size_t CompactITPSView::frameOffset(uint16_t i) const
+  {
+    if (!data_ || size_ < kHeaderBytes || data_[0] != kCompactITPSVersion || i >= readU16(data_ + 1))
+    {
+      return 0;
+    }
+    size_t off = kHeaderBytes;
+    for (uint16_t n = 0;; ++n)
+    {
+      if (off + kFrameFixedBytes > size_)
+      {
+        return 0;
+      }
+      const size_t dataAt = off + kFrameFixedBytes + static_cast<size_t>(data_[off + 6]) * 2;
+      if (dataAt + 2 > size_ || dataAt + 2 + readU16(data_ + dataAt) > size_ || !validMode(data_ + off))
+      {
+        return 0;
+      }
+      if (n == i)
+      {
+        return off;
+      }
+      off = dataAt + 2 + readU16(data_ + dataAt);
+    }
+  }
+
+  uint16_t CompactITPSView::frameCount() const
+  {
+    if (!data_ || size_ < kHeaderBytes)
+    {
+      return 0;
+    }
+    const uint16_t count = readU16(data_ + 1);
+    return (count > 0 && frameOffset(count - 1) != 0) ? count : 0;
+  }
+
+  CompactITPSView::Reader CompactITPSView::frame(uint16_t i) const
+  {
+    Reader r;
+    const size_t off = frameOffset(i);
+    if (off == 0)
+    {
+      return r;
+    }
+    const uint8_t *h = data_ + off; // frameOffset() checked the mode
+    const uint8_t mode = h[5];
+    const uint8_t indexBits = mode & 0x7;
+    const uint8_t paletteSize = h[6];
+    const uint8_t *dataBytes = h + kFrameFixedBytes + paletteSize * 2;
+    r.T_us_ = readU16(h);
+    r.len_ = r.left_ = readU16(h + 2);
+    r.flags_ = h[4];
+    r.indexBits_ = indexBits;
+    r.offsetBits_ = static_cast<uint8_t>(mode >> 3);
+    r.paletteSize_ = paletteSize;
+    r.palette_ = h + kFrameFixedBytes;
+    r.data_ = dataBytes + 2;
+    r.dataBits_ = static_cast<size_t>(readU16(dataBytes)) * 8;
+    return r;
+  }
+
+  uint32_t CompactITPSView::totalTimeUs() const
+  {
+    uint32_t total = 0;
+    const uint16_t count = frameCount();
+    for (uint16_t n = 0; n < count; ++n)
+    {
+      Reader r = frame(n);
+      uint32_t counts = 0;
+      int8_t v = 0;
+      while (r.next(v))
+      {
+        counts += (v < 0) ? static_cast<uint32_t>(-v) : static_cast<uint32_t>(v);
+      }
+      total += counts * static_cast<uint32_t>(r.T_us());
+    }
+    return total;
+  }
+
+  bool CompactITPSView::unpack(esp32ir::ITPSBuffer &out) const
+  {
+    out.clear();
+    const uint16_t count = frameCount();
+    if (count == 0)
+    {
+      return false;
+    }
+    for (uint16_t n = 0; n < count; ++n)
+    {
+      Reader r = frame(n);
+      if (r.T_us() == 0 || r.len() == 0)
+      {
+        return false;
+      }
+      int8_t *seq = out.appendFrame(r.T_us(), r.len(), r.flags());
+      if (!seq)
+      {
+        return false;
+      }
+      for (uint16_t i = 0; i < r.len(); ++i)
+      {
+        if (!r.next(seq[i]))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool CompactITPS::assign(const esp32ir::ITPSView &view)
+  {
+    bytes_.clear();
+    if (view.frameCount() == 0)
+    {
+      return false;
+    }
+    bytes_.push_back(kCompactITPSVersion);
+    putU16(bytes_, view.frameCount());
+    for (uint16_t n = 0; n < view.frameCount(); ++n)
+    {
+      const auto &f = view.frame(n);
+      if (!f.seq || f.len == 0 || f.T_us == 0)
+      {
+        bytes_.clear();
+        return false;
+      }
+      packFrame(f, bytes_);
+    }
+    return true;
+  }
+
+  esp32ir::PulseView makePulseView(const esp32ir::CompactITPSView &raw, esp32ir::Pulse *storage, size_t capacity)
+  {
+    size_t n = 0;
+    CompactITPSView::Reader r = raw.frame(0);
+    if (!storage || r.T_us() == 0)
+    {
+      return {storage, 0};
+    }
+    int8_t v = 0;
+    while (r.next(v))
+    {
+      if (v == 0)
+        continue;
+      esp32ir::Pulse p{v > 0, static_cast<uint32_t>((v < 0 ? -v : v) * r.T_us())};
+      if (n > 0 && storage[n - 1].mark == p.mark)
+      {
+        storage[n - 1].us += p.us;
+      }
+      else if (n < capacity)
+      {
+        storage[n++] = p;
+      }
+      else
+      {
+        break;
+      }
+    }
+    return {storage, n};
+  }
+
+} // namespace esp32ir
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <stdint.h>
-#include <vector>
 
 namespace esp32ir
 {
     namespace itps_encode
     {
-        inline void appendPulse(std::vector<int8_t> &seq, bool mark, uint32_t durationUs, uint16_t T_us)
+        // Append one mark/space as ITPS entries (split at 127 counts), passing each to append(int8_t).
+        template <typename Append>
+        inline void appendPulse(Append &&append, bool mark, uint32_t durationUs, uint16_t T_us)
         {
             if (T_us == 0 || durationUs == 0)
             {
@@ -20,10 +21,10 @@ namespace esp32ir
             }
             while (counts > 127)
             {
-                seq.push_back(mark ? 127 : -127);
+                append(static_cast<int8_t>(mark ? 127 : -127));
                 counts -= 127;
             }
-            seq.push_back(static_cast<int8_t>(mark ? counts : -static_cast<int>(counts)));
+            append(static_cast<int8_t>(mark ? counts : -static_cast<int>(counts)));
         }
     } // namespace itps_encode
 } // namespace esp32ir
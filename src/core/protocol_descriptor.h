@@ -0,0 +1,283 @@
+#pragma once
+
+#include "ESP32IRPulseCodec.h"
+#include "core/itps_encode.h"
+#include "core/pulse_utils.h"
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+namespace esp32ir
+{
+    namespace codec
+    {
+        enum class BitEncoding : uint8_t
+        {
+            PulseDistance, // fixed mark, the space length carries the bit (NEC, AEHA, ...)
+            PulseWidth,    // the mark length carries the bit, fixed space (SONY)
+            Biphase,       // Manchester halves of zeroMarkUs: 1 = mark/space, 0 = space/mark (RC5, RC6)
+        };
+
+        // Compile-time description of a mark/space codec. One entry drives both encode() and extract<D>(),
+        // so send and receive timings cannot drift apart. Build entries with pulseDistance()/pulseWidth()/biphase()
+        // and the with*() modifiers (see protocols/descriptors.h).
+        struct ProtocolDescriptor
+        {
+            BitEncoding encoding;
+            uint16_t txTUs;         // ITPS quantum used when sending
+            uint32_t headerMarkUs;  // 0: no header
+            uint32_t headerSpaceUs; // 0: no header space
+            uint32_t zeroMarkUs;    // Biphase: half-bit unit
+            uint32_t zeroSpaceUs;
+            uint32_t oneMarkUs;
+            uint32_t oneSpaceUs;
+            uint8_t minBits;
+            uint8_t maxBits;
+            uint8_t headerMarkTolPct;
+            uint8_t headerSpaceTolPct;
+            uint8_t markTolPct;
+            uint8_t spaceTolPct;
+            uint32_t trailerMarkUs; // 0: none
+            uint32_t repeatSpaceUs; // repeat frame = header mark + repeatSpaceUs + repeatMarkUs; 0: none
+            uint32_t repeatMarkUs;
+            uint8_t repeatTolPct;
+            uint8_t startBitUnits; // Biphase: width of the first bit in units (RC6 start bit is 2)
+
+            constexpr ProtocolDescriptor withTolerance(uint8_t hdrMark, uint8_t hdrSpace, uint8_t mark, uint8_t space) const
+            {
+                ProtocolDescriptor d = *this;
+                d.headerMarkTolPct = hdrMark;
+                d.headerSpaceTolPct = hdrSpace;
+                d.markTolPct = mark;
+                d.spaceTolPct = space;
+                return d;
+            }
+            constexpr ProtocolDescriptor withRepeat(uint32_t spaceUs, uint32_t markUs, uint8_t tolPct) const
+            {
+                ProtocolDescriptor d = *this;
+                d.repeatSpaceUs = spaceUs;
+                d.repeatMarkUs = markUs;
+                d.repeatTolPct = tolPct;
+                return d;
+            }
+            constexpr ProtocolDescriptor withHeader(uint32_t markUs, uint32_t spaceUs) const
+            {
+                ProtocolDescriptor d = *this;
+                d.headerMarkUs = markUs;
+                d.headerSpaceUs = spaceUs;
+                return d;
+            }
+            constexpr ProtocolDescriptor withStartBitUnits(uint8_t units) const
+            {
+                ProtocolDescriptor d = *this;
+                d.startBitUnits = units;
+                return d;
+            }
+        };
+
+        // Header, fixed bit mark, zero/one spaces; trailing stop mark equal to the bit mark.
+        // Tolerances default to 25% on the header and 30% on bits.
+        constexpr ProtocolDescriptor pulseDistance(uint32_t hdrMarkUs, uint32_t hdrSpaceUs, uint32_t bitMarkUs,
+                                                   uint32_t zeroSpaceUs, uint32_t oneSpaceUs, uint8_t minBits, uint8_t maxBits)
+        {
+            return {BitEncoding::PulseDistance, 10, hdrMarkUs, hdrSpaceUs, bitMarkUs, zeroSpaceUs, bitMarkUs, oneSpaceUs,
+                    minBits, maxBits, 25, 25, 30, 30, bitMarkUs, 0, 0, 0, 1};
+        }
+        // Header, zero/one marks, fixed bit space; no trailer.
+        constexpr ProtocolDescriptor pulseWidth(uint32_t hdrMarkUs, uint32_t hdrSpaceUs, uint32_t zeroMarkUs,
+                                                uint32_t oneMarkUs, uint32_t bitSpaceUs, uint8_t minBits, uint8_t maxBits)
+        {
+            return {BitEncoding::PulseWidth, 10, hdrMarkUs, hdrSpaceUs, zeroMarkUs, bitSpaceUs, oneMarkUs, bitSpaceUs,
+                    minBits, maxBits, 25, 35, 35, 35, 0, 0, 0, 0, 1};
+        }
+        // Manchester halves of unitUs, quantized at unitUs; no header unless withHeader().
+        constexpr ProtocolDescriptor biphase(uint16_t unitUs, uint8_t minBits, uint8_t maxBits)
+        {
+            return {BitEncoding::Biphase, unitUs, 0, 0, unitUs, unitUs, unitUs, unitUs,
+                    minBits, maxBits, 40, 40, 40, 40, 0, 0, 0, 0, 1};
+        }
+
+        // Same header and bit timings (and tolerances), so one extraction serves both.
+        constexpr bool sameTiming(const ProtocolDescriptor &a, const ProtocolDescriptor &b)
+        {
+            return a.encoding == b.encoding && a.headerMarkUs == b.headerMarkUs && a.headerSpaceUs == b.headerSpaceUs &&
+                   a.zeroMarkUs == b.zeroMarkUs && a.zeroSpaceUs == b.zeroSpaceUs && a.oneMarkUs == b.oneMarkUs &&
+                   a.oneSpaceUs == b.oneSpaceUs && a.headerMarkTolPct == b.headerMarkTolPct &&
+                   a.headerSpaceTolPct == b.headerSpaceTolPct && a.markTolPct == b.markTolPct && a.spaceTolPct == b.spaceTolPct;
+        }
+
+        constexpr uint32_t upperBoundUs(uint32_t us, uint8_t tolPct) { return us + us * tolPct / 100; }
+
+        // Longest mark or space a frame can contain, at the upper tolerance bound. Adjacent biphase halves of
+        // the same level merge, so a biphase run is up to two halves (or the leader plus the first half).
+        // Silence longer than this after the last edge means the frame is complete.
+        constexpr uint32_t longestSymbolUs(const ProtocolDescriptor &d)
+        {
+            if (d.encoding == BitEncoding::Biphase)
+            {
+                const uint32_t startUs = d.zeroMarkUs * d.startBitUnits;
+                const uint32_t leadUs = std::max(std::max(d.headerMarkUs, d.headerSpaceUs), startUs);
+                return upperBoundUs(leadUs + startUs, d.markTolPct);
+            }
+            return std::max(std::max(upperBoundUs(d.headerMarkUs, d.headerMarkTolPct), upperBoundUs(d.headerSpaceUs, d.headerSpaceTolPct)),
+                            std::max(upperBoundUs(std::max(d.zeroMarkUs, d.oneMarkUs), d.markTolPct),
+                                     upperBoundUs(std::max(d.zeroSpaceUs, d.oneSpaceUs), d.spaceTolPct)));
+        }
+
+        // Why bit extraction stopped.
+        enum class Stop : uint8_t
+        {
+            End,   // ran out of pulses
+            Mark,  // a bit mark was out of range (or a level was out of order)
+            Space, // a bit space was out of range
+            Gap,   // PulseWidth: a space longer than the bit space (end-of-frame gap)
+        };
+
+        // Header match plus every consecutive valid bit after it (LSB first, up to 64).
+        // A fixed-length member needing N bits accepts the frame when has(N), and reads take(N).
+        struct Bits
+        {
+            bool header;
+            uint8_t count;
+            uint64_t data;
+            Stop stop;
+
+            bool has(uint8_t bits) const { return header && count >= bits; }
+            uint64_t take(uint8_t bits) const { return bits >= 64 ? data : (data & ((uint64_t{1} << bits) - 1)); }
+        };
+
+        template <const ProtocolDescriptor &D>
+        Bits extract(const esp32ir::PulseView &pulses)
+        {
+            static_assert(D.encoding != BitEncoding::Biphase, "biphase frames are decoded by their protocol (T from the leader)");
+            Bits out{false, 0, 0, Stop::End};
+            if (pulses.size() < 2 || !pulses[0].mark || pulses[1].mark ||
+                !esp32ir::inRange(pulses[0].us, D.headerMarkUs, D.headerMarkTolPct) ||
+                !esp32ir::inRange(pulses[1].us, D.headerSpaceUs, D.headerSpaceTolPct))
+            {
+                return out;
+            }
+            out.header = true;
+            if (D.encoding == BitEncoding::PulseDistance)
+            {
+                for (size_t idx = 2; idx + 1 < pulses.size() && out.count < 64; idx += 2)
+                {
+                    const auto &m = pulses[idx];
+                    const auto &sp = pulses[idx + 1];
+                    if (!m.mark || !esp32ir::inRange(m.us, D.zeroMarkUs, D.markTolPct) || sp.mark)
+                    {
+                        out.stop = Stop::Mark;
+                        break;
+                    }
+                    bool one = esp32ir::inRange(sp.us, D.oneSpaceUs, D.spaceTolPct);
+                    if (!one && !esp32ir::inRange(sp.us, D.zeroSpaceUs, D.spaceTolPct))
+                    {
+                        out.stop = Stop::Space;
+                        break;
+                    }
+                    if (one)
+                        out.data |= (uint64_t{1} << out.count);
+                    ++out.count;
+                }
+                return out;
+            }
+            // PulseWidth: the last bit may end the frame (no space) or be followed by a long gap.
+            constexpr uint32_t kThresholdUs = (D.zeroMarkUs + D.oneMarkUs) / 2;
+            size_t idx = 2;
+            while (out.count < 64)
+            {
+                if (idx >= pulses.size())
+                {
+                    break;
+                }
+                const auto &m = pulses[idx];
+                if (!m.mark || !(esp32ir::inRange(m.us, D.zeroMarkUs, D.markTolPct) || esp32ir::inRange(m.us, D.oneMarkUs, D.markTolPct)))
+                {
+                    out.stop = Stop::Mark;
+                    break;
+                }
+                if (m.us > kThresholdUs)
+                    out.data |= (uint64_t{1} << out.count);
+                ++out.count;
+                if (++idx >= pulses.size())
+                {
+                    break;
+                }
+                const auto &sp = pulses[idx];
+                if (!sp.mark && esp32ir::inRange(sp.us, D.zeroSpaceUs, D.spaceTolPct))
+                {
+                    ++idx;
+                    continue;
+                }
+                out.stop = (!sp.mark && sp.us >= D.zeroSpaceUs) ? Stop::Gap : Stop::Space;
+                break;
+            }
+            return out;
+        }
+
+        // Frame for the first bitCount bits of txBytes (LSB first per byte, as built by buildTxBitstream), built
+        // into buf (cleared first; its storage is reused). Returns buf; a frame that does not fit fixed storage
+        // leaves buf.overflowed() set.
+        // Sending is not timing-critical, so the descriptor is read at run time and all protocols share one copy.
+        inline const esp32ir::ITPSBuffer &encode(const ProtocolDescriptor &D, const std::vector<uint8_t> &txBytes, uint16_t bitCount,
+                                                 esp32ir::ITPSBuffer &buf)
+        {
+            buf.clear();
+            if (bitCount == 0 || txBytes.size() * 8 < bitCount)
+            {
+                return buf;
+            }
+            // Entries go straight into the buffer (no intermediate vector).
+            buf.reserve(1, static_cast<uint16_t>(bitCount * 2 + 6));
+            buf.beginFrame(D.txTUs);
+            auto seq = [&buf](int8_t v)
+            { buf.appendEntry(v); };
+            if (D.headerMarkUs)
+            {
+                itps_encode::appendPulse(seq, true, D.headerMarkUs, D.txTUs);
+            }
+            if (D.headerSpaceUs)
+            {
+                itps_encode::appendPulse(seq, false, D.headerSpaceUs, D.txTUs);
+            }
+            for (uint16_t i = 0; i < bitCount; ++i)
+            {
+                bool one = (txBytes[i / 8] >> (i % 8)) & 0x1;
+                if (D.encoding == BitEncoding::Biphase)
+                {
+                    // Halves are appended separately (not merged), one quantum each.
+                    uint32_t halfUs = D.zeroMarkUs * ((i == 0) ? D.startBitUnits : 1);
+                    itps_encode::appendPulse(seq, one, halfUs, D.txTUs);
+                    itps_encode::appendPulse(seq, !one, halfUs, D.txTUs);
+                }
+                else
+                {
+                    itps_encode::appendPulse(seq, true, one ? D.oneMarkUs : D.zeroMarkUs, D.txTUs);
+                    itps_encode::appendPulse(seq, false, one ? D.oneSpaceUs : D.zeroSpaceUs, D.txTUs);
+                }
+            }
+            if (D.trailerMarkUs)
+            {
+                itps_encode::appendPulse(seq, true, D.trailerMarkUs, D.txTUs);
+            }
+            return buf;
+        }
+
+        // Repeat frame: header mark, repeat space, repeat mark (empty if the protocol has none).
+        inline const esp32ir::ITPSBuffer &encodeRepeat(const ProtocolDescriptor &D, esp32ir::ITPSBuffer &buf)
+        {
+            buf.clear();
+            if (D.repeatSpaceUs == 0)
+            {
+                return buf;
+            }
+            buf.beginFrame(D.txTUs);
+            auto seq = [&buf](int8_t v)
+            { buf.appendEntry(v); };
+            itps_encode::appendPulse(seq, true, D.headerMarkUs, D.txTUs);
+            itps_encode::appendPulse(seq, false, D.repeatSpaceUs, D.txTUs);
+            itps_encode::appendPulse(seq, true, D.repeatMarkUs, D.txTUs);
+            return buf;
+        }
+    } // namespace codec
+} // namespace esp32ir
@@ -1,14 +1,33 @@
 #pragma once
 
 #include "ESP32IRPulseCodec.h"
-#include <vector>
+#include <algorithm>
+#include <stddef.h>
 
 namespace esp32ir
 {
-    struct Pulse
+    // Fixed-capacity pulse list for the decoders so decoding never touches the heap.
+    // Pulses past kCapacity are dropped; every decoder only inspects the leading part of a frame.
+    class PulseBuffer
     {
-        bool mark;
-        uint32_t us;
+    public:
+        static constexpr size_t kCapacity = 128;
+
+        void clear() { size_ = 0; }
+        // Merge frame 0 of raw (see makePulseView); false when it yields no pulses.
+        bool assign(const esp32ir::ITPSView &raw)
+        {
+            size_ = esp32ir::makePulseView(raw, items_, kCapacity).size();
+            return size_ > 0;
+        }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const Pulse &operator[](size_t i) const { return items_[i]; }
+        PulseView view() const { return {items_, size_}; }
+
+    private:
+        Pulse items_[kCapacity];
+        size_t size_{0};
     };
 
     inline bool inRange(uint32_t v, uint32_t target, uint32_t tolPercent)
@@ -18,45 +37,34 @@ namespace esp32ir
         return v >= lo && v <= hi;
     }
 
-    inline bool collectPulses(const esp32ir::ITPSBuffer &raw, std::vector<Pulse> &out)
+    // ITPS entries needed to express `pulses` at T_us (each pulse split greedily into ±127 chunks).
+    inline size_t itpsEntryCount(const PulseView &pulses, uint16_t T_us)
     {
-        out.clear();
-        if (raw.frameCount() == 0)
+        size_t n = 0;
+        for (size_t i = 0; i < pulses.size(); ++i)
         {
-            return false;
+            n += (pulses[i].us / T_us + 126) / 127;
         }
-        const auto &f = raw.frame(0);
-        if (!f.seq || f.len == 0 || f.T_us == 0)
-        {
-            return false;
-        }
-        out.reserve(f.len);
-        Pulse last{false, 0};
-        bool hasLast = false;
-        for (uint16_t i = 0; i < f.len; ++i)
+        return n;
+    }
+
+    // Write the ITPS entries for `pulses` into seq (sized by itpsEntryCount).
+    inline void pulsesToITPS(const PulseView &pulses, uint16_t T_us, int8_t *seq)
+    {
+        for (size_t i = 0; i < pulses.size(); ++i)
         {
-            int v = f.seq[i];
-            if (v == 0)
-                continue;
-            Pulse p{v > 0, static_cast<uint32_t>((v < 0 ? -v : v) * f.T_us)};
-            if (hasLast && last.mark == p.mark)
-            {
-                last.us += p.us;
-            }
-            else
+            uint32_t counts = pulses[i].us / T_us;
+            while (counts > 0)
             {
-                if (hasLast)
-                {
-                    out.push_back(last);
-                }
-                last = p;
-                hasLast = true;
+                int8_t v = static_cast<int8_t>(std::min<uint32_t>(counts, 127));
+                *seq++ = pulses[i].mark ? v : static_cast<int8_t>(-v);
+                counts -= static_cast<uint32_t>(v);
             }
         }
-        if (hasLast)
-        {
-            out.push_back(last);
-        }
-        return !out.empty();
+    }
+
+    inline bool collectPulses(const esp32ir::ITPSView &raw, PulseBuffer &out)
+    {
+        return out.assign(raw);
     }
 } // namespace esp32ir
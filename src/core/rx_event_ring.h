@@ -0,0 +1,151 @@
+#pragma once
+
+// Lock-free handoff of RMT receive events from the RX ISR (producer) to poll()/the decode task (consumer).
+// Platform-agnostic (std::atomic only) so it can be exercised on a host with std::thread.
+//
+// An event is packed into one 32-bit word (receive buffer index, symbol count, is_last), so a slot is a single
+// atomic and neither side ever copies a descriptor struct that the other side may be writing.
+// head_/tail_ are running counters (slot = counter % depth): a stale tail can never look current again,
+// which lets the producer reclaim the oldest event (DROP_OLDEST) with the same CAS the consumer uses to take it.
+// They wrap at the largest multiple of the depth below 2^31, not at 2^32, so the slot sequence stays continuous
+// across the wrap for any depth (2^32 is only a multiple of power-of-two depths).
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esp32ir
+{
+    struct RxEventDesc
+    {
+        uint8_t buffer;    // receive buffer index (0..31)
+        bool last;         // rmt_rx_done_event_data_t::flags.is_last
+        uint32_t symbols;  // received symbols (< 2^26)
+
+        static constexpr uint32_t kMaxSymbols = (1u << 26) - 1;
+
+        uint32_t pack() const
+        {
+            return (static_cast<uint32_t>(buffer) & 0x1Fu) | (last ? 0x20u : 0u) | (symbols << 6);
+        }
+        static RxEventDesc unpack(uint32_t word)
+        {
+            return {static_cast<uint8_t>(word & 0x1Fu), (word & 0x20u) != 0, word >> 6};
+        }
+    };
+
+    class RxEventRing
+    {
+    public:
+        RxEventRing() = default;
+        RxEventRing(const RxEventRing &) = delete;
+        RxEventRing &operator=(const RxEventRing &) = delete;
+
+        // Not thread-safe: call while neither side is running. first: initial counter (tests start near the wrap).
+        bool init(size_t depth, uint32_t first = 0)
+        {
+            if (depth == 0 || depth > kWrapLimit)
+            {
+                return false;
+            }
+            std::vector<std::atomic<uint32_t>>(depth).swap(slots_);
+            wrap_ = static_cast<uint32_t>(kWrapLimit / depth * depth);
+            head_.store(first % wrap_, std::memory_order_relaxed);
+            tail_.store(first % wrap_, std::memory_order_relaxed);
+            return true;
+        }
+        void release()
+        {
+            std::vector<std::atomic<uint32_t>>().swap(slots_);
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        size_t capacity() const { return slots_.size(); }
+        size_t size() const
+        {
+            uint32_t t = tail_.load(std::memory_order_acquire);
+            return distance(head_.load(std::memory_order_acquire), t);
+        }
+
+        // Producer side: false when full (nothing is written).
+        bool push(const RxEventDesc &ev)
+        {
+            if (slots_.empty())
+            {
+                return false;
+            }
+            uint32_t h = head_.load(std::memory_order_relaxed);
+            if (distance(h, tail_.load(std::memory_order_acquire)) >= slots_.size())
+            {
+                return false;
+            }
+            slots_[h % slots_.size()].store(ev.pack(), std::memory_order_relaxed);
+            head_.store(next(h), std::memory_order_release); // publishes the slot (and the symbols in its buffer)
+            return true;
+        }
+
+        // Producer side: take back the oldest queued event so its buffer can be reused. False when the consumer
+        // emptied the ring first (a push will then succeed).
+        bool dropOldest(RxEventDesc &out) { return take(out, false); }
+
+        // Consumer side: oldest queued event, or false when empty.
+        bool pop(RxEventDesc &out) { return take(out, true); }
+
+        // Consumer side: oldest queued event without taking it. The producer may drop it (DROP_OLDEST) right
+        // after, so the result is only a hint.
+        bool peek(RxEventDesc &out) const
+        {
+            if (slots_.empty())
+            {
+                return false;
+            }
+            uint32_t t = tail_.load(std::memory_order_acquire);
+            if (t == head_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            out = RxEventDesc::unpack(slots_[t % slots_.size()].load(std::memory_order_relaxed));
+            return true;
+        }
+
+    private:
+        static constexpr uint32_t kWrapLimit = 0x80000000u;
+
+        uint32_t next(uint32_t i) const { return i + 1 == wrap_ ? 0 : i + 1; }
+        uint32_t distance(uint32_t head, uint32_t tail) const { return head >= tail ? head - tail : head + wrap_ - tail; }
+
+        bool take(RxEventDesc &out, bool retry)
+        {
+            if (slots_.empty())
+            {
+                return false;
+            }
+            uint32_t t = tail_.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (t == head_.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+                uint32_t word = slots_[t % slots_.size()].load(std::memory_order_relaxed);
+                // Whoever advances tail_ owns the event; the loser sees the new tail in t.
+                if (tail_.compare_exchange_strong(t, next(t), std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    out = RxEventDesc::unpack(word);
+                    return true;
+                }
+                if (!retry)
+                {
+                    return false;
+                }
+            }
+        }
+
+        std::vector<std::atomic<uint32_t>> slots_;
+        std::atomic<uint32_t> head_{0};
+        std::atomic<uint32_t> tail_{0};
+        uint32_t wrap_{kWrapLimit}; // counters run in [0, wrap_), a multiple of the depth
+    };
+} // namespace esp32ir
@@ -0,0 +1,63 @@
+#pragma once
+
+// Order in which a ReceiverGroup takes captures from its sources (one Receiver per RX pin).
+// Platform-agnostic (no RMT/FreeRTOS) so the fan-in can be exercised on a host with simulated sources.
+//
+// The group decodes every source in one shared arena, so a source whose capture is not finished (pending
+// frames, or a capture still arriving as partial RMT events) keeps it until it is; only then does the source
+// with the oldest queued capture go next. Captures are therefore delivered in the order the RX ISRs queued
+// them, except that a capture already being decoded is completed first.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp32ir
+{
+    class RxFanIn
+    {
+    public:
+        // Keep taking from source until release() (its capture left work in the shared arena).
+        void hold(size_t source) { held_ = static_cast<int>(source); }
+        void release() { held_ = -1; }
+        int held() const { return held_; }
+
+        // Source to take from next, or -1 when none has a queued capture.
+        // oldest(i, us) returns true and the ISR stamp of source i's oldest queued capture if it has one.
+        // Equal stamps go round-robin, starting after the source taken last.
+        template <typename Oldest>
+        int next(size_t count, Oldest oldest)
+        {
+            if (held_ >= 0)
+            {
+                return held_;
+            }
+            int best = -1;
+            int64_t bestUs = 0;
+            for (size_t k = 1; k <= count; ++k)
+            {
+                const size_t i = (static_cast<size_t>(last_ + 1) + k - 1) % count;
+                int64_t us = 0;
+                if (oldest(i, us) && (best < 0 || us < bestUs))
+                {
+                    best = static_cast<int>(i);
+                    bestUs = us;
+                }
+            }
+            if (best >= 0)
+            {
+                last_ = best;
+            }
+            return best;
+        }
+
+        void reset()
+        {
+            held_ = -1;
+            last_ = -1;
+        }
+
+    private:
+        int held_{-1};
+        int last_{-1};
+    };
+} // namespace esp32ir
@@ -0,0 +1,113 @@
+#pragma once
+
+// Lock-free single-producer/single-consumer ring of preallocated slots.
+// Platform-agnostic (std::atomic only) so it can be exercised on a host with std::thread.
+// The producer fills a slot in place (writeSlot/publish) and the consumer reads it in place (readSlot/pop);
+// slots are never destroyed, so buffers inside T keep their capacity from one use to the next.
+
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+namespace esp32ir
+{
+    template <typename T>
+    class SpscRing
+    {
+    public:
+        SpscRing() = default;
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        // Not thread-safe: call while neither side is running.
+        bool init(size_t depth)
+        {
+            if (depth == 0)
+            {
+                return false;
+            }
+            slots_.clear();
+            slots_.resize(depth + 1); // one slot stays empty to tell full from empty
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        void release()
+        {
+            std::vector<T>().swap(slots_);
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        // Not thread-safe: visit every slot (e.g. to preallocate buffers) while neither side is running.
+        template <typename F>
+        void forEachSlot(F &&f)
+        {
+            for (auto &slot : slots_)
+            {
+                f(slot);
+            }
+        }
+
+        size_t capacity() const { return slots_.empty() ? 0 : slots_.size() - 1; }
+        size_t size() const
+        {
+            if (slots_.empty())
+            {
+                return 0;
+            }
+            size_t h = head_.load(std::memory_order_acquire);
+            size_t t = tail_.load(std::memory_order_acquire);
+            return (h + slots_.size() - t) % slots_.size();
+        }
+
+        // Producer side: slot to fill, or nullptr when full.
+        T *writeSlot()
+        {
+            if (slots_.empty())
+            {
+                return nullptr;
+            }
+            size_t h = head_.load(std::memory_order_relaxed);
+            if (next(h) == tail_.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+            return &slots_[h];
+        }
+        // Producer side: make the slot returned by writeSlot() visible to the consumer.
+        void publish()
+        {
+            size_t h = head_.load(std::memory_order_relaxed);
+            head_.store(next(h), std::memory_order_release);
+        }
+
+        // Consumer side: oldest published slot, or nullptr when empty.
+        T *readSlot()
+        {
+            if (slots_.empty())
+            {
+                return nullptr;
+            }
+            size_t t = tail_.load(std::memory_order_relaxed);
+            if (t == head_.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+            return &slots_[t];
+        }
+        // Consumer side: hand the slot returned by readSlot() back to the producer.
+        void pop()
+        {
+            size_t t = tail_.load(std::memory_order_relaxed);
+            tail_.store(next(t), std::memory_order_release);
+        }
+
+    private:
+        size_t next(size_t i) const { return (i + 1 == slots_.size()) ? 0 : i + 1; }
+
+        std::vector<T> slots_;
+        std::atomic<size_t> head_{0};
+        std::atomic<size_t> tail_{0};
+    };
+} // namespace esp32ir
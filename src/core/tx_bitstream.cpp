@@ -20,8 +20,10 @@ namespace esp32ir
                 out[byteIndex] |= static_cast<uint8_t>(1u << (bitIndex % 8));
             ++bitIndex;
         };
+        (void)addBit; // unused when only NEC is compiled in
         switch (message.protocol)
         {
+#if ESP32IR_ENABLE_NEC
         case esp32ir::Protocol::NEC:
         {
             if (message.length != sizeof(esp32ir::payload::NEC) || message.data == nullptr)
@@ -34,6 +36,8 @@ namespace esp32ir
             bitCount = ok ? 32 : 0;
             return ok;
         }
+#endif
+#if ESP32IR_ENABLE_SONY
         case esp32ir::Protocol::SONY:
         {
             if (message.length != sizeof(esp32ir::payload::SONY) || message.data == nullptr)
@@ -51,6 +55,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_AEHA
         case esp32ir::Protocol::AEHA:
         {
             if (message.length != sizeof(esp32ir::payload::AEHA) || message.data == nullptr)
@@ -69,6 +75,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_PANASONIC
         case esp32ir::Protocol::Panasonic:
         {
             if (message.length != sizeof(esp32ir::payload::Panasonic) || message.data == nullptr)
@@ -87,6 +95,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_JVC
         case esp32ir::Protocol::JVC:
         {
             if (message.length != sizeof(esp32ir::payload::JVC) || message.data == nullptr)
@@ -112,6 +122,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG
         case esp32ir::Protocol::Samsung:
         {
             if (message.length != sizeof(esp32ir::payload::Samsung) || message.data == nullptr)
@@ -126,6 +138,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG36
         case esp32ir::Protocol::Samsung36:
         {
             if (message.length != sizeof(esp32ir::payload::Samsung36) || message.data == nullptr)
@@ -142,6 +156,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_LG
         case esp32ir::Protocol::LG:
         {
             if (message.length != sizeof(esp32ir::payload::LG) || message.data == nullptr)
@@ -156,6 +172,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_DENON
         case esp32ir::Protocol::Denon:
         {
             if (message.length != sizeof(esp32ir::payload::Denon) || message.data == nullptr)
@@ -170,6 +188,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_RC5
         case esp32ir::Protocol::RC5:
         {
             if (message.length != sizeof(esp32ir::payload::RC5) || message.data == nullptr)
@@ -190,6 +210,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_RC6
         case esp32ir::Protocol::RC6:
         {
             if (message.length != sizeof(esp32ir::payload::RC6) || message.data == nullptr)
@@ -208,6 +230,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_APPLE
         case esp32ir::Protocol::Apple:
         {
             if (message.length != sizeof(esp32ir::payload::Apple) || message.data == nullptr)
@@ -224,6 +248,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_PIONEER
         case esp32ir::Protocol::Pioneer:
         {
             if (message.length != sizeof(esp32ir::payload::Pioneer) || message.data == nullptr)
@@ -240,6 +266,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_TOSHIBA
         case esp32ir::Protocol::Toshiba:
         {
             if (message.length != sizeof(esp32ir::payload::Toshiba) || message.data == nullptr)
@@ -256,6 +284,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_MITSUBISHI
         case esp32ir::Protocol::Mitsubishi:
         {
             if (message.length != sizeof(esp32ir::payload::Mitsubishi) || message.data == nullptr)
@@ -272,6 +302,8 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
+#if ESP32IR_ENABLE_HITACHI
         case esp32ir::Protocol::Hitachi:
         {
             if (message.length != sizeof(esp32ir::payload::Hitachi) || message.data == nullptr)
@@ -288,6 +320,7 @@ namespace esp32ir
             bitCount = bitIndex;
             return true;
         }
+#endif
         default:
             // For unsupported protocols, fall back to raw bytes (if any)
             if (message.data && message.length)
@@ -0,0 +1,99 @@
+#ifndef ESP32IRPULSECODEC_CONFIG_H
+#define ESP32IRPULSECODEC_CONFIG_H
+
+// Compile-time protocol selection.
+// Every codec is built unless disabled. A disabled protocol's decoder, encoder and its branches in
+// Receiver/Transmitter dispatch are not compiled, so they cost no flash.
+//   Drop one protocol:      -DESP32IR_ENABLE_AEHA=0
+//   Only NEC and SONY:      -DESP32IR_DEFAULT_ENABLE=0 -DESP32IR_ENABLE_NEC=1 -DESP32IR_ENABLE_SONY=1
+// The macros must be the same for the library and the sketch (e.g. PlatformIO build_flags).
+
+#ifndef ESP32IR_DEFAULT_ENABLE
+#define ESP32IR_DEFAULT_ENABLE 1
+#endif
+
+#ifndef ESP32IR_ENABLE_NEC
+#define ESP32IR_ENABLE_NEC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_SONY
+#define ESP32IR_ENABLE_SONY ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_AEHA
+#define ESP32IR_ENABLE_AEHA ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_PANASONIC
+#define ESP32IR_ENABLE_PANASONIC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_JVC
+#define ESP32IR_ENABLE_JVC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_SAMSUNG
+#define ESP32IR_ENABLE_SAMSUNG ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_SAMSUNG36
+#define ESP32IR_ENABLE_SAMSUNG36 ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_LG
+#define ESP32IR_ENABLE_LG ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_DENON
+#define ESP32IR_ENABLE_DENON ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_RC5
+#define ESP32IR_ENABLE_RC5 ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_RC6
+#define ESP32IR_ENABLE_RC6 ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_APPLE
+#define ESP32IR_ENABLE_APPLE ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_PIONEER
+#define ESP32IR_ENABLE_PIONEER ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_TOSHIBA
+#define ESP32IR_ENABLE_TOSHIBA ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_MITSUBISHI
+#define ESP32IR_ENABLE_MITSUBISHI ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_HITACHI
+#define ESP32IR_ENABLE_HITACHI ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_DAIKINAC
+#define ESP32IR_ENABLE_DAIKINAC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_PANASONICAC
+#define ESP32IR_ENABLE_PANASONICAC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_MITSUBISHIAC
+#define ESP32IR_ENABLE_MITSUBISHIAC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_TOSHIBAAC
+#define ESP32IR_ENABLE_TOSHIBAAC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#ifndef ESP32IR_ENABLE_FUJITSUAC
+#define ESP32IR_ENABLE_FUJITSUAC ESP32IR_DEFAULT_ENABLE
+#endif
+
+#endif // ESP32IRPULSECODEC_CONFIG_H
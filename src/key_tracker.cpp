@@ -0,0 +1,236 @@
+#include "ESP32IRPulseCodec.h"
+#include <esp_timer.h>
+#include <cstddef>
+#include <cstring>
+
+namespace esp32ir
+{
+
+    namespace
+    {
+        // Byte of the message that marks a repeat code (NEC/Denon), or -1. Repeat codes carry no address or
+        // command, so they continue the held key instead of being compared with it. RC5/RC6 toggle bits need no
+        // special case: a changed toggle makes the message differ, which starts a new press.
+        int repeatFlagOffset(esp32ir::Protocol p)
+        {
+            switch (p)
+            {
+            case esp32ir::Protocol::NEC:
+                return static_cast<int>(offsetof(esp32ir::payload::NEC, repeat));
+            case esp32ir::Protocol::Denon:
+                return static_cast<int>(offsetof(esp32ir::payload::Denon, repeat));
+            default:
+                return -1;
+            }
+        }
+
+        bool isACProtocol(esp32ir::Protocol p)
+        {
+            switch (p)
+            {
+            case esp32ir::Protocol::DaikinAC:
+            case esp32ir::Protocol::PanasonicAC:
+            case esp32ir::Protocol::MitsubishiAC:
+            case esp32ir::Protocol::ToshibaAC:
+            case esp32ir::Protocol::FujitsuAC:
+                return true;
+            default:
+                return false;
+            }
+        }
+    } // namespace
+
+    bool KeyTracker::setRepeatWindowUs(uint32_t windowUs)
+    {
+        if (windowUs == 0)
+        {
+            return false;
+        }
+        windowUs_ = windowUs;
+        return true;
+    }
+
+    bool KeyTracker::setHoldIntervalUs(uint32_t holdIntervalUs)
+    {
+        holdIntervalUs_ = holdIntervalUs;
+        return true;
+    }
+
+    bool KeyTracker::feed(const esp32ir::RxResult &result)
+    {
+        const esp32ir::ProtocolMessage &msg = result.message;
+        if (result.status != esp32ir::RxStatus::DECODED || result.protocol == esp32ir::Protocol::RAW ||
+            isACProtocol(result.protocol) || !msg.data || msg.length == 0 || msg.length > KeyEvent::kMaxCodeBytes)
+        {
+            return false;
+        }
+        int64_t firstUs = result.timing.firstEdgeUs;
+        int64_t lastUs = result.timing.lastEdgeUs;
+        if (lastUs == 0)
+        {
+            firstUs = lastUs = esp_timer_get_time(); // decode() results carry no timing
+        }
+
+        Key *key = nullptr;
+        for (auto &k : keys_)
+        {
+            if (k.down && k.protocol == result.protocol && k.source == result.source)
+            {
+                key = &k;
+                break;
+            }
+        }
+        if (key && firstUs - key->lastUs > static_cast<int64_t>(windowUs_))
+        {
+            push(*key, esp32ir::KeyEventType::RELEASE); // released before next() noticed
+            key->down = false;
+            key = nullptr;
+        }
+
+        const int flag = repeatFlagOffset(result.protocol);
+        const bool repeatCode = flag >= 0 && flag < msg.length && msg.data[flag] != 0;
+        const bool sameCode = key && key->codeLength == msg.length && memcmp(key->code, msg.data, msg.length) == 0;
+        if (repeatCode && !key)
+        {
+            return false; // the press was missed; there is no code to report
+        }
+        if (repeatCode || sameCode)
+        {
+            if (key->count < UINT16_MAX)
+            {
+                ++key->count;
+            }
+            key->lastUs = lastUs;
+            if (lastUs - key->lastHoldUs >= static_cast<int64_t>(holdIntervalUs_))
+            {
+                key->lastHoldUs = lastUs;
+                push(*key, esp32ir::KeyEventType::HOLD);
+            }
+            return true;
+        }
+
+        if (key)
+        {
+            push(*key, esp32ir::KeyEventType::RELEASE); // another key of the same remote
+        }
+        else
+        {
+            for (auto &k : keys_)
+            {
+                if (!k.down)
+                {
+                    key = &k;
+                    break;
+                }
+            }
+            if (!key)
+            {
+                key = &keys_[0];
+                for (auto &k : keys_)
+                {
+                    if (k.lastUs < key->lastUs)
+                    {
+                        key = &k;
+                    }
+                }
+                push(*key, esp32ir::KeyEventType::RELEASE);
+            }
+        }
+        key->down = true;
+        key->protocol = result.protocol;
+        key->source = result.source;
+        key->count = 1;
+        key->pressUs = firstUs;
+        key->lastUs = lastUs;
+        key->lastHoldUs = firstUs;
+        key->codeLength = static_cast<uint8_t>(msg.length);
+        memcpy(key->code, msg.data, msg.length);
+        push(*key, esp32ir::KeyEventType::PRESS);
+        return true;
+    }
+
+    bool KeyTracker::next(esp32ir::KeyEvent &out, int64_t nowUs)
+    {
+        if (pop(out))
+        {
+            return true;
+        }
+        for (auto &k : keys_)
+        {
+            if (k.down && nowUs - k.lastUs > static_cast<int64_t>(windowUs_))
+            {
+                k.down = false;
+                push(k, esp32ir::KeyEventType::RELEASE);
+                return pop(out);
+            }
+        }
+        return false;
+    }
+
+    bool KeyTracker::next(esp32ir::KeyEvent &out)
+    {
+        return next(out, esp_timer_get_time());
+    }
+
+    bool KeyTracker::poll(esp32ir::Receiver &rx, esp32ir::KeyEvent &out)
+    {
+        while (rx.poll(result_))
+        {
+            feed(result_);
+        }
+        return next(out);
+    }
+
+    bool KeyTracker::poll(esp32ir::ReceiverGroup &group, esp32ir::KeyEvent &out)
+    {
+        while (group.poll(result_))
+        {
+            feed(result_);
+        }
+        return next(out);
+    }
+
+    void KeyTracker::reset()
+    {
+        for (auto &k : keys_)
+        {
+            k.down = false;
+        }
+        queueHead_ = 0;
+        queueCount_ = 0;
+        droppedEvents_ = 0;
+    }
+
+    void KeyTracker::push(const Key &key, esp32ir::KeyEventType type)
+    {
+        if (queueCount_ == kQueueDepth)
+        {
+            ++droppedEvents_;
+            return;
+        }
+        esp32ir::KeyEvent &ev = queue_[(queueHead_ + queueCount_) % kQueueDepth];
+        ++queueCount_;
+        ev.type = type;
+        ev.protocol = key.protocol;
+        ev.source = key.source;
+        ev.count = key.count;
+        const int64_t duration = key.lastUs - key.pressUs;
+        ev.durationUs = duration <= 0 ? 0 : (duration > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(duration));
+        ev.timeUs = key.lastUs;
+        ev.codeLength = key.codeLength;
+        memcpy(ev.code, key.code, key.codeLength);
+    }
+
+    bool KeyTracker::pop(esp32ir::KeyEvent &out)
+    {
+        if (queueCount_ == 0)
+        {
+            return false;
+        }
+        out = queue_[queueHead_];
+        queueHead_ = (queueHead_ + 1) % kQueueDepth;
+        --queueCount_;
+        return true;
+    }
+
+} // namespace esp32ir
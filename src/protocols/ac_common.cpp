@@ -62,18 +62,30 @@ namespace esp32ir
     bool decodeAC(const esp32ir::RxResult &in, const esp32ir::ac::Capabilities &capabilities, esp32ir::ac::DeviceState &out)
     {
         Protocol proto = protocolFromCapabilities(capabilities);
+        (void)in; // unused when no AC protocol is enabled
+        (void)out;
         switch (proto)
         {
+#if ESP32IR_ENABLE_DAIKINAC
         case Protocol::DaikinAC:
             return decodeDaikinAC(in, capabilities, out);
+#endif
+#if ESP32IR_ENABLE_PANASONICAC
         case Protocol::PanasonicAC:
             return decodePanasonicAC(in, capabilities, out);
+#endif
+#if ESP32IR_ENABLE_MITSUBISHIAC
         case Protocol::MitsubishiAC:
             return decodeMitsubishiAC(in, capabilities, out);
+#endif
+#if ESP32IR_ENABLE_TOSHIBAAC
         case Protocol::ToshibaAC:
             return decodeToshibaAC(in, capabilities, out);
+#endif
+#if ESP32IR_ENABLE_FUJITSUAC
         case Protocol::FujitsuAC:
             return decodeFujitsuAC(in, capabilities, out);
+#endif
         default:
             ESP_LOGW("ESP32IRPulseCodec", "decodeAC: unsupported AC protocol");
             return false;
@@ -83,18 +95,29 @@ namespace esp32ir
     bool Transmitter::sendAC(const esp32ir::ac::DeviceState &state, const esp32ir::ac::Capabilities &capabilities)
     {
         Protocol proto = protocolFromCapabilities(capabilities);
+        (void)state; // unused when no AC protocol is enabled
         switch (proto)
         {
+#if ESP32IR_ENABLE_DAIKINAC
         case Protocol::DaikinAC:
             return sendDaikinAC(state, capabilities);
+#endif
+#if ESP32IR_ENABLE_PANASONICAC
         case Protocol::PanasonicAC:
             return sendPanasonicAC(state, capabilities);
+#endif
+#if ESP32IR_ENABLE_MITSUBISHIAC
         case Protocol::MitsubishiAC:
             return sendMitsubishiAC(state, capabilities);
+#endif
+#if ESP32IR_ENABLE_TOSHIBAAC
         case Protocol::ToshibaAC:
             return sendToshibaAC(state, capabilities);
+#endif
+#if ESP32IR_ENABLE_FUJITSUAC
         case Protocol::FujitsuAC:
             return sendFujitsuAC(state, capabilities);
+#endif
         default:
             ESP_LOGW("ESP32IRPulseCodec", "sendAC: unsupported AC protocol");
             return false;
@@ -5,6 +5,8 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_DAIKINAC
+
     bool decodeDaikinAC(const esp32ir::RxResult &in, const esp32ir::ac::Capabilities &, esp32ir::ac::DeviceState &)
     {
         ESP_LOGW("ESP32IRPulseCodec", "decodeDaikinAC (common AC API) not implemented");
@@ -17,4 +19,6 @@ namespace esp32ir
         return false;
     }
 
+#endif // ESP32IR_ENABLE_DAIKINAC
+
 } // namespace esp32ir
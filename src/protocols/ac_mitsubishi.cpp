@@ -5,6 +5,8 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_MITSUBISHIAC
+
     bool decodeMitsubishiAC(const esp32ir::RxResult &in, const esp32ir::ac::Capabilities &, esp32ir::ac::DeviceState &)
     {
         ESP_LOGW("ESP32IRPulseCodec", "decodeMitsubishiAC (common AC API) not implemented");
@@ -17,4 +19,6 @@ namespace esp32ir
         return false;
     }
 
+#endif // ESP32IR_ENABLE_MITSUBISHIAC
+
 } // namespace esp32ir
@@ -5,6 +5,29 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_APPLE
+
+    namespace nec_like
+    {
+        bool decodeApple(const Bits &bits, esp32ir::payload::Apple &out)
+        {
+            if (!bits.has(codec::kApple.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kApple.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint8_t>((data >> 16) & 0xFF);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeApple(const esp32ir::PulseView &pulses, esp32ir::payload::Apple &out)
+    {
+        out = {};
+        return nec_like::decodeApple(nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
     bool decodeApple(const esp32ir::RxResult &in, esp32ir::payload::Apple &out)
     {
         out = {};
@@ -12,36 +35,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 32, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint8_t>((data >> 16) & 0xFF);
-        return true;
+        return decodeApple(in.raw.view(), out);
+    }
+    bool decodeApple(const esp32ir::ITPSView &raw, esp32ir::payload::Apple &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeApple(pulses.view(), out);
     }
     bool Transmitter::sendApple(const esp32ir::payload::Apple &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Apple, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Apple));
+        return sendEncoded(codec::encode(codec::kApple, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Apple);
     }
     bool Transmitter::sendApple(uint16_t address, uint8_t command)
     {
@@ -49,4 +57,6 @@ namespace esp32ir
         return sendApple(p);
     }
 
+#endif // ESP32IR_ENABLE_APPLE
+
 } // namespace esp32ir
@@ -18,64 +18,67 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
-    bool decodeDenon(const esp32ir::RxResult &in, esp32ir::payload::Denon &out)
+#if ESP32IR_ENABLE_DENON
+
+    namespace nec_like
     {
-        out = {};
-        if (decodeMessage(in, esp32ir::Protocol::Denon, out))
+        bool decodeDenon(const esp32ir::PulseView &pulses, const Bits &bits, esp32ir::payload::Denon &out)
         {
-            return true;
-        }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kRepeatSpaceUs = 2250;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
+            constexpr const codec::ProtocolDescriptor &d = codec::kDenon;
 
-        // Strict repeat detection: 9000/2250/560 pattern only.
-        std::vector<esp32ir::Pulse> pulses;
-        if (esp32ir::collectPulses(in.raw, pulses))
-        {
+            // Strict repeat detection: 9000/2250/560 pattern only.
             auto inTol = [&](const esp32ir::Pulse &p, bool mark, uint32_t target, uint32_t tol)
             {
                 return p.mark == mark && esp32ir::inRange(p.us, target, tol);
             };
-            if (pulses.size() >= 3 && inTol(pulses[0], true, kHdrMarkUs, 25) && inTol(pulses[1], false, kRepeatSpaceUs, 25) && inTol(pulses[2], true, kBitMarkUs, 30))
+            if (pulses.size() >= 3 && inTol(pulses[0], true, d.headerMarkUs, d.headerMarkTolPct) && inTol(pulses[1], false, d.repeatSpaceUs, d.repeatTolPct) && inTol(pulses[2], true, d.repeatMarkUs, d.markTolPct))
             {
                 out.address = 0;
                 out.command = 0;
                 out.repeat = true;
                 return true;
             }
-        }
 
-        if (nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 32, data))
-        {
+            if (!bits.has(d.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(d.maxBits);
             out.address = static_cast<uint16_t>(data & 0xFFFF);
             out.command = static_cast<uint16_t>(data >> 16);
             out.repeat = false;
             return true;
         }
-        return false;
+    } // namespace nec_like
+
+    bool decodeDenon(const esp32ir::PulseView &pulses, esp32ir::payload::Denon &out)
+    {
+        out = {};
+        return nec_like::decodeDenon(pulses, nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
+    bool decodeDenon(const esp32ir::RxResult &in, esp32ir::payload::Denon &out)
+    {
+        out = {};
+        if (decodeMessage(in, esp32ir::Protocol::Denon, out))
+        {
+            return true;
+        }
+        return decodeDenon(in.raw.view(), out);
+    }
+    bool decodeDenon(const esp32ir::ITPSView &raw, esp32ir::payload::Denon &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeDenon(pulses.view(), out);
     }
     bool Transmitter::sendDenon(const esp32ir::payload::Denon &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Denon, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Denon));
+        return sendEncoded(codec::encode(codec::kDenon, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Denon);
     }
     bool Transmitter::sendDenon(uint16_t address, uint16_t command, bool repeat)
     {
@@ -83,4 +86,6 @@ namespace esp32ir
         return sendDenon(p);
     }
 
+#endif // ESP32IR_ENABLE_DENON
+
 } // namespace esp32ir
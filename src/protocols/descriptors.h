@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core/protocol_descriptor.h"
+
+namespace esp32ir
+{
+    namespace codec
+    {
+        // One entry per mark/space protocol: encode() and extract<kX>() both read their timings from it.
+        // AC protocols are byte-framed and keep their own codecs.
+
+        // 9000/4500 header, 560/560/1690 bits
+        inline constexpr ProtocolDescriptor kNEC = pulseDistance(9000, 4500, 560, 560, 1690, 32, 32).withRepeat(2250, 560, 30);
+        inline constexpr ProtocolDescriptor kDenon = pulseDistance(9000, 4500, 560, 560, 1690, 32, 32).withRepeat(2250, 560, 25);
+        inline constexpr ProtocolDescriptor kLG = pulseDistance(9000, 4500, 560, 560, 1690, 32, 32);
+        inline constexpr ProtocolDescriptor kApple = pulseDistance(9000, 4500, 560, 560, 1690, 32, 32);
+        inline constexpr ProtocolDescriptor kPioneer = pulseDistance(9000, 4500, 560, 560, 1690, 40, 40);
+        inline constexpr ProtocolDescriptor kToshiba = pulseDistance(9000, 4500, 560, 560, 1690, 40, 40);
+        inline constexpr ProtocolDescriptor kMitsubishi = pulseDistance(9000, 4500, 560, 560, 1690, 40, 40);
+        inline constexpr ProtocolDescriptor kHitachi = pulseDistance(9000, 4500, 560, 560, 1690, 40, 40);
+        // 4500/4500 header, 560/560/1690 bits
+        inline constexpr ProtocolDescriptor kSamsung = pulseDistance(4500, 4500, 560, 560, 1690, 32, 32);
+        inline constexpr ProtocolDescriptor kSamsung36 = pulseDistance(4500, 4500, 560, 560, 1690, 36, 36);
+        inline constexpr ProtocolDescriptor kJVC = pulseDistance(8400, 4200, 525, 525, 1575, 24, 32);
+        inline constexpr ProtocolDescriptor kPanasonic = pulseDistance(3500, 1750, 502, 424, 1244, 32, 32);
+        // 425us unit: 8T/4T header, T/T/3T bits
+        inline constexpr ProtocolDescriptor kAEHA = pulseDistance(3400, 1700, 425, 425, 1275, 24, 48).withTolerance(30, 30, 30, 35);
+        inline constexpr ProtocolDescriptor kSONY = pulseWidth(2400, 600, 600, 1200, 600, 12, 20);
+        // start bits + toggle + 5 address + 6 command
+        inline constexpr ProtocolDescriptor kRC5 = biphase(889, 14, 14);
+        // 2T/2T leader, double-width start bit + 3 mode + toggle + 16 command
+        inline constexpr ProtocolDescriptor kRC6 = biphase(444, 21, 21).withHeader(888, 888).withStartBitUnits(2);
+    } // namespace codec
+} // namespace esp32ir
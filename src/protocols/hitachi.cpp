@@ -5,6 +5,30 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_HITACHI
+
+    namespace nec_like
+    {
+        bool decodeHitachi(const Bits &bits, esp32ir::payload::Hitachi &out)
+        {
+            if (!bits.has(codec::kHitachi.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kHitachi.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
+            out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeHitachi(const esp32ir::PulseView &pulses, esp32ir::payload::Hitachi &out)
+    {
+        out = {};
+        return nec_like::decodeHitachi(nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
     bool decodeHitachi(const esp32ir::RxResult &in, esp32ir::payload::Hitachi &out)
     {
         out = {};
@@ -12,37 +36,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 40, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
-        out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
-        return true;
+        return decodeHitachi(in.raw.view(), out);
+    }
+    bool decodeHitachi(const esp32ir::ITPSView &raw, esp32ir::payload::Hitachi &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeHitachi(pulses.view(), out);
     }
     bool Transmitter::sendHitachi(const esp32ir::payload::Hitachi &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Hitachi, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Hitachi));
+        return sendEncoded(codec::encode(codec::kHitachi, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Hitachi);
     }
     bool Transmitter::sendHitachi(uint16_t address, uint16_t command, uint8_t extra)
     {
@@ -50,4 +58,6 @@ namespace esp32ir
         return sendHitachi(p);
     }
 
+#endif // ESP32IR_ENABLE_HITACHI
+
 } // namespace esp32ir
@@ -19,57 +19,56 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
-    bool decodeJVC(const esp32ir::RxResult &in, esp32ir::payload::JVC &out)
-    {
-        out = {};
-        if (decodeMessage(in, esp32ir::Protocol::JVC, out))
-        {
-            return true;
-        }
-        constexpr uint32_t kHdrMarkUs = 8400;
-        constexpr uint32_t kHdrSpaceUs = 4200;
-        constexpr uint32_t kBitMarkUs = 525;
-        constexpr uint32_t kZeroSpaceUs = 525;
-        constexpr uint32_t kOneSpaceUs = 1575;
+#if ESP32IR_ENABLE_JVC
 
-        auto tryBits = [&](uint8_t bits) -> bool
+    namespace nec_like
+    {
+        bool decodeJVC(const Bits &bits, esp32ir::payload::JVC &out)
         {
-            uint64_t data = 0;
-            if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, bits, data))
-                return false;
-            if (bits == 32)
+            // Longest frame first: a 32-bit frame also carries a valid 24-bit prefix.
+            if (bits.has(codec::kJVC.maxBits))
             {
+                uint64_t data = bits.take(codec::kJVC.maxBits);
                 out.address = static_cast<uint16_t>(data & 0xFFFF);
                 out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
+                out.bits = 32;
+                return true;
             }
-            else if (bits == 24)
+            if (bits.has(codec::kJVC.minBits))
             {
+                uint64_t data = bits.take(codec::kJVC.minBits);
                 out.address = static_cast<uint16_t>(data & 0xFFFF);
                 out.command = static_cast<uint16_t>((data >> 16) & 0xFF);
+                out.bits = 24;
+                return true;
             }
-            else
-            {
-                return false;
-            }
-            out.bits = bits;
-            return true;
-        };
+            return false;
+        }
+    } // namespace nec_like
 
-        if (tryBits(32))
-            return true;
-        if (tryBits(24))
+    bool decodeJVC(const esp32ir::PulseView &pulses, esp32ir::payload::JVC &out)
+    {
+        out = {};
+        return nec_like::decodeJVC(nec_like::extract(pulses, nec_like::Family::JVC), out);
+    }
+
+    bool decodeJVC(const esp32ir::RxResult &in, esp32ir::payload::JVC &out)
+    {
+        out = {};
+        if (decodeMessage(in, esp32ir::Protocol::JVC, out))
+        {
             return true;
-        return false;
+        }
+        return decodeJVC(in.raw.view(), out);
+    }
+    bool decodeJVC(const esp32ir::ITPSView &raw, esp32ir::payload::JVC &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeJVC(pulses.view(), out);
     }
     bool Transmitter::sendJVC(const esp32ir::payload::JVC &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 8400;
-        constexpr uint32_t kHdrSpaceUs = 4200;
-        constexpr uint32_t kBitMarkUs = 525;
-        constexpr uint32_t kZeroSpaceUs = 525;
-        constexpr uint32_t kOneSpaceUs = 1575;
-
         esp32ir::payload::JVC fixed = p;
         uint8_t bits = fixed.bits ? fixed.bits : 32;
         if (bits != 24 && bits != 32)
@@ -82,14 +81,11 @@ namespace esp32ir
         {
             fixed.command &= 0x00FF;
         }
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::JVC, reinterpret_cast<const uint8_t *>(&fixed), static_cast<uint16_t>(sizeof(fixed)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::JVC));
+        return sendEncoded(codec::encode(codec::kJVC, txBytes_, bitCount, txFrame_), esp32ir::Protocol::JVC);
     }
     bool Transmitter::sendJVC(uint16_t address, uint16_t command, uint8_t bits)
     {
@@ -97,4 +93,6 @@ namespace esp32ir
         return sendJVC(p);
     }
 
+#endif // ESP32IR_ENABLE_JVC
+
 } // namespace esp32ir
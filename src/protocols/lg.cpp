@@ -18,6 +18,29 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
+#if ESP32IR_ENABLE_LG
+
+    namespace nec_like
+    {
+        bool decodeLG(const Bits &bits, esp32ir::payload::LG &out)
+        {
+            if (!bits.has(codec::kLG.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kLG.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint16_t>(data >> 16);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeLG(const esp32ir::PulseView &pulses, esp32ir::payload::LG &out)
+    {
+        out = {};
+        return nec_like::decodeLG(nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
     bool decodeLG(const esp32ir::RxResult &in, esp32ir::payload::LG &out)
     {
         out = {};
@@ -25,37 +48,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 32, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint16_t>(data >> 16);
-        return true;
+        return decodeLG(in.raw.view(), out);
+    }
+    bool decodeLG(const esp32ir::ITPSView &raw, esp32ir::payload::LG &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeLG(pulses.view(), out);
     }
     bool Transmitter::sendLG(const esp32ir::payload::LG &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::LG, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::LG));
+        return sendEncoded(codec::encode(codec::kLG, txBytes_, bitCount, txFrame_), esp32ir::Protocol::LG);
     }
     bool Transmitter::sendLG(uint16_t address, uint16_t command)
     {
@@ -63,4 +70,6 @@ namespace esp32ir
         return sendLG(p);
     }
 
+#endif // ESP32IR_ENABLE_LG
+
 } // namespace esp32ir
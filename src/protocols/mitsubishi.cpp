@@ -18,6 +18,30 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::KEEP_GAP_IN_FRAME};
     }
 
+#if ESP32IR_ENABLE_MITSUBISHI
+
+    namespace nec_like
+    {
+        bool decodeMitsubishi(const Bits &bits, esp32ir::payload::Mitsubishi &out)
+        {
+            if (!bits.has(codec::kMitsubishi.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kMitsubishi.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
+            out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeMitsubishi(const esp32ir::PulseView &pulses, esp32ir::payload::Mitsubishi &out)
+    {
+        out = {};
+        return nec_like::decodeMitsubishi(nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
     bool decodeMitsubishi(const esp32ir::RxResult &in, esp32ir::payload::Mitsubishi &out)
     {
         out = {};
@@ -25,37 +49,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 40, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
-        out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
-        return true;
+        return decodeMitsubishi(in.raw.view(), out);
+    }
+    bool decodeMitsubishi(const esp32ir::ITPSView &raw, esp32ir::payload::Mitsubishi &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeMitsubishi(pulses.view(), out);
     }
     bool Transmitter::sendMitsubishi(const esp32ir::payload::Mitsubishi &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Mitsubishi, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Mitsubishi));
+        return sendEncoded(codec::encode(codec::kMitsubishi, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Mitsubishi);
     }
     bool Transmitter::sendMitsubishi(uint16_t address, uint16_t command, uint8_t extra)
     {
@@ -63,4 +71,6 @@ namespace esp32ir
         return sendMitsubishi(p);
     }
 
+#endif // ESP32IR_ENABLE_MITSUBISHI
+
 } // namespace esp32ir
@@ -1,121 +1,95 @@
 #pragma once
 
 #include "ESP32IRPulseCodec.h"
-#include "core/itps_encode.h"
 #include "core/pulse_utils.h"
-#include <vector>
+#include "descriptors.h"
 
 namespace esp32ir
 {
     namespace nec_like
     {
-        inline esp32ir::ITPSBuffer build(uint16_t T_us,
-                                         uint32_t headerMarkUs,
-                                         uint32_t headerSpaceUs,
-                                         uint32_t bitMarkUs,
-                                         uint32_t zeroSpaceUs,
-                                         uint32_t oneSpaceUs,
-                                         uint64_t data,
-                                         uint8_t bits,
-                                         bool trailingMark = true)
+        // Pulse-distance families: members share header and bit timing, so one extraction serves them all.
+        enum class Family : uint8_t
         {
-            std::vector<int8_t> seq;
-            seq.reserve(static_cast<size_t>(bits) * 2 + 6);
-            if (headerMarkUs)
-            {
-                itps_encode::appendPulse(seq, true, headerMarkUs, T_us);
-            }
-            if (headerSpaceUs)
-            {
-                itps_encode::appendPulse(seq, false, headerSpaceUs, T_us);
-            }
-            for (uint8_t i = 0; i < bits; ++i)
-            {
-                bool one = (data >> i) & 0x1;
-                itps_encode::appendPulse(seq, true, bitMarkUs, T_us);
-                itps_encode::appendPulse(seq, false, one ? oneSpaceUs : zeroSpaceUs, T_us);
-            }
-            if (trailingMark)
+            NEC,       // 9000/4500, 560/560/1690: NEC, LG, Pioneer, Apple, Toshiba, Mitsubishi, Hitachi, Denon
+            Samsung,   // 4500/4500, 560/560/1690: Samsung, Samsung36
+            JVC,       // 8400/4200, 525/525/1575
+            Panasonic, // 3500/1750, 502/424/1244
+        };
+        constexpr size_t kFamilyCount = 4;
+
+        static_assert(codec::sameTiming(codec::kNEC, codec::kDenon) && codec::sameTiming(codec::kNEC, codec::kLG) &&
+                          codec::sameTiming(codec::kNEC, codec::kApple) && codec::sameTiming(codec::kNEC, codec::kPioneer) &&
+                          codec::sameTiming(codec::kNEC, codec::kToshiba) && codec::sameTiming(codec::kNEC, codec::kMitsubishi) &&
+                          codec::sameTiming(codec::kNEC, codec::kHitachi),
+                      "NEC family members must share timing");
+        static_assert(codec::sameTiming(codec::kSamsung, codec::kSamsung36), "Samsung family members must share timing");
+
+        using Bits = codec::Bits;
+
+        inline Bits extract(const esp32ir::PulseView &pulses, Family family)
+        {
+            // Families with no enabled member are not instantiated.
+            (void)pulses; // unused when no pulse-distance family is enabled
+            switch (family)
             {
-                itps_encode::appendPulse(seq, true, bitMarkUs, T_us);
+#if ESP32IR_ENABLE_NEC || ESP32IR_ENABLE_DENON || ESP32IR_ENABLE_LG || ESP32IR_ENABLE_APPLE || ESP32IR_ENABLE_PIONEER || \
+    ESP32IR_ENABLE_TOSHIBA || ESP32IR_ENABLE_MITSUBISHI || ESP32IR_ENABLE_HITACHI
+            case Family::NEC:
+                return codec::extract<codec::kNEC>(pulses);
+#endif
+#if ESP32IR_ENABLE_SAMSUNG || ESP32IR_ENABLE_SAMSUNG36
+            case Family::Samsung:
+                return codec::extract<codec::kSamsung>(pulses);
+#endif
+#if ESP32IR_ENABLE_JVC
+            case Family::JVC:
+                return codec::extract<codec::kJVC>(pulses);
+#endif
+#if ESP32IR_ENABLE_PANASONIC
+            case Family::Panasonic:
+                return codec::extract<codec::kPanasonic>(pulses);
+#endif
+            default:
+                return Bits{false, 0, 0, codec::Stop::End};
             }
-            esp32ir::ITPSFrame frame{T_us, static_cast<uint16_t>(seq.size()), seq.data(), 0};
-            esp32ir::ITPSBuffer buf;
-            buf.addFrame(frame);
-            return buf;
         }
 
-        inline bool decodeRaw(const esp32ir::RxResult &in,
-                              uint32_t headerMarkUs,
-                              uint32_t headerSpaceUs,
-                              uint32_t bitMarkUs,
-                              uint32_t zeroSpaceUs,
-                              uint32_t oneSpaceUs,
-                              uint8_t bits,
-                              uint64_t &outData)
+        // Per-frame cache: each family is extracted at most once however many members are tried.
+        class BitsCache
         {
-            std::vector<esp32ir::Pulse> pulses;
-            if (!esp32ir::collectPulses(in.raw, pulses))
+        public:
+            explicit BitsCache(const esp32ir::PulseView &pulses) : pulses_(pulses) {}
+            const Bits &get(Family family)
             {
-                return false;
-            }
-            size_t idx = 0;
-            auto expect = [&](bool mark, uint32_t targetUs, uint32_t tol) -> bool
-            {
-                if (idx >= pulses.size())
-                    return false;
-                const auto &p = pulses[idx];
-                if (p.mark != mark || !esp32ir::inRange(p.us, targetUs, tol))
-                    return false;
-                ++idx;
-                return true;
-            };
-            if (headerMarkUs && headerSpaceUs)
-            {
-                if (!expect(true, headerMarkUs, 25) || !expect(false, headerSpaceUs, 25))
+                size_t i = static_cast<size_t>(family);
+                if (!ready_[i])
                 {
-                    return false;
+                    bits_[i] = extract(pulses_, family);
+                    ready_[i] = true;
                 }
+                return bits_[i];
             }
-            uint64_t data = 0;
-            for (uint8_t i = 0; i < bits; ++i)
-            {
-                if (!expect(true, bitMarkUs, 30))
-                    return false;
-                if (idx >= pulses.size() || pulses[idx].mark)
-                    return false;
-                bool one = esp32ir::inRange(pulses[idx].us, oneSpaceUs, 30);
-                bool zero = esp32ir::inRange(pulses[idx].us, zeroSpaceUs, 30);
-                if (!one && !zero)
-                    return false;
-                if (one)
-                    data |= (uint64_t{1} << i);
-                ++idx;
-            }
-            outData = data;
-            return true;
-        }
 
-        inline esp32ir::ITPSBuffer buildFromTxBytes(uint16_t T_us,
-                                                    uint32_t headerMarkUs,
-                                                    uint32_t headerSpaceUs,
-                                                    uint32_t bitMarkUs,
-                                                    uint32_t zeroSpaceUs,
-                                                    uint32_t oneSpaceUs,
-                                                    const std::vector<uint8_t> &txBytes,
-                                                    uint8_t bits,
-                                                    bool trailingMark = true)
-        {
-            if (bits == 0 || bits > 64)
-                return esp32ir::ITPSBuffer{};
-            uint64_t data = 0;
-            for (uint8_t i = 0; i < bits; ++i)
-            {
-                uint8_t b = txBytes[i / 8];
-                if ((b >> (i % 8)) & 0x1)
-                    data |= (uint64_t{1} << i);
-            }
-            return build(T_us, headerMarkUs, headerSpaceUs, bitMarkUs, zeroSpaceUs, oneSpaceUs, data, bits, trailingMark);
-        }
+        private:
+            esp32ir::PulseView pulses_;
+            Bits bits_[kFamilyCount]{};
+            bool ready_[kFamilyCount]{};
+        };
+
+        // Family members classified from an extraction (bit count and integrity checks only).
+        // Each is defined next to its protocol; decodeX(const PulseView &) is extract + classify.
+        bool decodeNEC(const esp32ir::PulseView &pulses, const Bits &bits, esp32ir::payload::NEC &out);
+        bool decodeDenon(const esp32ir::PulseView &pulses, const Bits &bits, esp32ir::payload::Denon &out);
+        bool decodeLG(const Bits &bits, esp32ir::payload::LG &out);
+        bool decodePioneer(const Bits &bits, esp32ir::payload::Pioneer &out);
+        bool decodeApple(const Bits &bits, esp32ir::payload::Apple &out);
+        bool decodeToshiba(const Bits &bits, esp32ir::payload::Toshiba &out);
+        bool decodeMitsubishi(const Bits &bits, esp32ir::payload::Mitsubishi &out);
+        bool decodeHitachi(const Bits &bits, esp32ir::payload::Hitachi &out);
+        bool decodeSamsung(const Bits &bits, esp32ir::payload::Samsung &out);
+        bool decodeSamsung36(const Bits &bits, esp32ir::payload::Samsung36 &out);
+        bool decodeJVC(const Bits &bits, esp32ir::payload::JVC &out);
+        bool decodePanasonic(const Bits &bits, esp32ir::payload::Panasonic &out);
     } // namespace nec_like
 } // namespace esp32ir
@@ -19,6 +19,30 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
+#if ESP32IR_ENABLE_PANASONIC
+
+    namespace nec_like
+    {
+        bool decodePanasonic(const Bits &bits, esp32ir::payload::Panasonic &out)
+        {
+            if (!bits.has(codec::kPanasonic.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kPanasonic.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.data = static_cast<uint32_t>(data >> 16);
+            out.nbits = 16;
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodePanasonic(const esp32ir::PulseView &pulses, esp32ir::payload::Panasonic &out)
+    {
+        out = {};
+        return nec_like::decodePanasonic(nec_like::extract(pulses, nec_like::Family::Panasonic), out);
+    }
+
     bool decodePanasonic(const esp32ir::RxResult &in, esp32ir::payload::Panasonic &out)
     {
         out = {};
@@ -26,39 +50,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 3500;
-        constexpr uint32_t kHdrSpaceUs = 1750;
-        constexpr uint32_t kBitMarkUs = 502;
-        constexpr uint32_t kZeroSpaceUs = 424;
-        constexpr uint32_t kOneSpaceUs = 1244;
-        uint8_t bits = 32;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, bits, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.data = static_cast<uint32_t>(data >> 16);
-        out.nbits = 16;
-        return true;
+        return decodePanasonic(in.raw.view(), out);
+    }
+    bool decodePanasonic(const esp32ir::ITPSView &raw, esp32ir::payload::Panasonic &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodePanasonic(pulses.view(), out);
     }
     bool Transmitter::sendPanasonic(const esp32ir::payload::Panasonic &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 3500;
-        constexpr uint32_t kHdrSpaceUs = 1750;
-        constexpr uint32_t kBitMarkUs = 502;
-        constexpr uint32_t kZeroSpaceUs = 424;
-        constexpr uint32_t kOneSpaceUs = 1244;
-
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Panasonic, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Panasonic));
+        return sendEncoded(codec::encode(codec::kPanasonic, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Panasonic);
     }
     bool Transmitter::sendPanasonic(uint16_t address, uint32_t data, uint8_t nbits)
     {
@@ -66,4 +72,6 @@ namespace esp32ir
         return sendPanasonic(p);
     }
 
+#endif // ESP32IR_ENABLE_PANASONIC
+
 } // namespace esp32ir
@@ -1,23 +1,18 @@
 #include "ESP32IRPulseCodec.h"
 #include "core/message_utils.h"
-#include "core/itps_encode.h"
 #include "core/pulse_utils.h"
+#include "descriptors.h"
 #include <vector>
 
 namespace esp32ir
 {
 
-    bool decodeRC5(const esp32ir::RxResult &in, esp32ir::payload::RC5 &out)
+#if ESP32IR_ENABLE_RC5
+
+    bool decodeRC5(const esp32ir::PulseView &pulses, esp32ir::payload::RC5 &out)
     {
         out = {};
-        if (decodeMessage(in, esp32ir::Protocol::RC5, out))
-        {
-            return true;
-        }
-        std::vector<esp32ir::Pulse> pulses;
-        if (!esp32ir::collectPulses(in.raw, pulses))
-            return false;
-        if (pulses.size() < 28) // 14 bits * 2 halves
+        if (pulses.size() < 2u * codec::kRC5.maxBits) // two halves per bit
             return false;
         uint32_t T = pulses[0].us;
         size_t idx = 0;
@@ -28,7 +23,7 @@ namespace esp32ir
             return pulses[idx++];
         };
         auto okHalf = [&](const esp32ir::Pulse &p)
-        { return esp32ir::inRange(p.us, T, 40); };
+        { return esp32ir::inRange(p.us, T, codec::kRC5.markTolPct); };
         // Start bits: 1,1 -> mark/space, mark/space
         esp32ir::Pulse a = nextHalf(), b = nextHalf();
         if (!a.mark || b.mark || !okHalf(a) || !okHalf(b))
@@ -63,47 +58,29 @@ namespace esp32ir
         out.command = cmd;
         return true;
     }
-    namespace
+
+    bool decodeRC5(const esp32ir::RxResult &in, esp32ir::payload::RC5 &out)
     {
-        constexpr uint16_t kTUs = 889;
-        void appendHalf(std::vector<int8_t> &seq, bool mark)
-        {
-            itps_encode::appendPulse(seq, mark, kTUs, kTUs);
-        }
-        void appendBit(std::vector<int8_t> &seq, bool bit)
+        out = {};
+        if (decodeMessage(in, esp32ir::Protocol::RC5, out))
         {
-            if (bit)
-            {
-                appendHalf(seq, true);
-                appendHalf(seq, false);
-            }
-            else
-            {
-                appendHalf(seq, false);
-                appendHalf(seq, true);
-            }
+            return true;
         }
-    } // namespace
-
+        return decodeRC5(in.raw.view(), out);
+    }
+    bool decodeRC5(const esp32ir::ITPSView &raw, esp32ir::payload::RC5 &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeRC5(pulses.view(), out);
+    }
     bool Transmitter::sendRC5(const esp32ir::payload::RC5 &p)
     {
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::RC5, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-
-        std::vector<int8_t> seq;
-        seq.reserve(32);
-        for (uint16_t i = 0; i < bitCount; ++i)
-        {
-            bool bit = (txBytes[i / 8] >> (i % 8)) & 0x1;
-            appendBit(seq, bit);
-        }
-        esp32ir::ITPSFrame frame{kTUs, static_cast<uint16_t>(seq.size()), seq.data(), 0};
-        esp32ir::ITPSBuffer buf;
-        buf.addFrame(frame);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::RC5));
+        return sendEncoded(codec::encode(codec::kRC5, txBytes_, bitCount, txFrame_), esp32ir::Protocol::RC5);
     }
     bool Transmitter::sendRC5(uint16_t command, bool toggle)
     {
@@ -111,4 +88,6 @@ namespace esp32ir
         return sendRC5(p);
     }
 
+#endif // ESP32IR_ENABLE_RC5
+
 } // namespace esp32ir
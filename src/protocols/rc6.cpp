@@ -1,7 +1,7 @@
 #include "ESP32IRPulseCodec.h"
 #include "core/message_utils.h"
-#include "core/itps_encode.h"
 #include "core/pulse_utils.h"
+#include "descriptors.h"
 #include <vector>
 
 namespace esp32ir
@@ -20,16 +20,11 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
-    bool decodeRC6(const esp32ir::RxResult &in, esp32ir::payload::RC6 &out)
+#if ESP32IR_ENABLE_RC6
+
+    bool decodeRC6(const esp32ir::PulseView &pulses, esp32ir::payload::RC6 &out)
     {
         out = {};
-        if (decodeMessage(in, esp32ir::Protocol::RC6, out))
-        {
-            return true;
-        }
-        std::vector<esp32ir::Pulse> pulses;
-        if (!esp32ir::collectPulses(in.raw, pulses))
-            return false;
         if (pulses.size() < 40)
             return false;
         size_t idx = 0;
@@ -41,19 +36,20 @@ namespace esp32ir
         };
         auto ok = [&](const esp32ir::Pulse &p, uint32_t target, uint32_t tol)
         { return esp32ir::inRange(p.us, target, tol); };
+        constexpr uint32_t kTol = codec::kRC6.markTolPct;
         // Leader 2T mark 2T space
         esp32ir::Pulse p1 = take(), p2 = take();
-        if (!p1.mark || p2.mark || !ok(p1, p1.us, 40) || !ok(p2, p1.us, 40))
+        if (!p1.mark || p2.mark || !ok(p1, p1.us, kTol) || !ok(p2, p1.us, kTol))
             return false;
         uint32_t T = p1.us / 2;
         // start bit double width
         esp32ir::Pulse s1 = take(), s2 = take();
-        if (!s1.mark || s2.mark || !ok(s1, 2 * T, 40) || !ok(s2, 2 * T, 40))
+        if (!s1.mark || s2.mark || !ok(s1, 2 * T, kTol) || !ok(s2, 2 * T, kTol))
             return false;
         auto decodeBit = [&](bool &bit) -> bool
         {
             esp32ir::Pulse h1 = take(), h2 = take();
-            if (!ok(h1, T, 40) || !ok(h2, T, 40))
+            if (!ok(h1, T, kTol) || !ok(h2, T, kTol))
                 return false;
             bit = h1.mark && !h2.mark;
             return true;
@@ -80,60 +76,29 @@ namespace esp32ir
         }
         return true;
     }
-    namespace
+
+    bool decodeRC6(const esp32ir::RxResult &in, esp32ir::payload::RC6 &out)
     {
-        constexpr uint16_t kTUs = 444;
-        void appendHalf(std::vector<int8_t> &seq, bool mark)
-        {
-            itps_encode::appendPulse(seq, mark, kTUs, kTUs);
-        }
-        void appendBit(std::vector<int8_t> &seq, bool bit)
+        out = {};
+        if (decodeMessage(in, esp32ir::Protocol::RC6, out))
         {
-            if (bit)
-            {
-                appendHalf(seq, true);
-                appendHalf(seq, false);
-            }
-            else
-            {
-                appendHalf(seq, false);
-                appendHalf(seq, true);
-            }
+            return true;
         }
-    } // namespace
-
+        return decodeRC6(in.raw.view(), out);
+    }
+    bool decodeRC6(const esp32ir::ITPSView &raw, esp32ir::payload::RC6 &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeRC6(pulses.view(), out);
+    }
     bool Transmitter::sendRC6(const esp32ir::payload::RC6 &p)
     {
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::RC6, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-
-        std::vector<int8_t> seq;
-        seq.reserve(64);
-        // Leader 2T mark, 2T space
-        itps_encode::appendPulse(seq, true, kTUs * 2, kTUs);
-        itps_encode::appendPulse(seq, false, kTUs * 2, kTUs);
-        // Start bit (always 1) with double width Manchester
-        // TxBitstream bit0 is the start bit
-        for (uint16_t i = 0; i < bitCount; ++i)
-        {
-            bool bit = (txBytes[i / 8] >> (i % 8)) & 0x1;
-            if (i == 0)
-            {
-                itps_encode::appendPulse(seq, true, kTUs * 2, kTUs);
-                itps_encode::appendPulse(seq, false, kTUs * 2, kTUs);
-            }
-            else
-            {
-                appendBit(seq, bit);
-            }
-        }
-        esp32ir::ITPSFrame frame{kTUs, static_cast<uint16_t>(seq.size()), seq.data(), 0};
-        esp32ir::ITPSBuffer buf;
-        buf.addFrame(frame);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::RC6));
+        return sendEncoded(codec::encode(codec::kRC6, txBytes_, bitCount, txFrame_), esp32ir::Protocol::RC6);
     }
     bool Transmitter::sendRC6(uint32_t command, uint8_t mode, bool toggle)
     {
@@ -141,4 +106,6 @@ namespace esp32ir
         return sendRC6(p);
     }
 
+#endif // ESP32IR_ENABLE_RC6
+
 } // namespace esp32ir
@@ -5,6 +5,29 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_SAMSUNG
+
+    namespace nec_like
+    {
+        bool decodeSamsung(const Bits &bits, esp32ir::payload::Samsung &out)
+        {
+            if (!bits.has(codec::kSamsung.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kSamsung.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint16_t>(data >> 16);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeSamsung(const esp32ir::PulseView &pulses, esp32ir::payload::Samsung &out)
+    {
+        out = {};
+        return nec_like::decodeSamsung(nec_like::extract(pulses, nec_like::Family::Samsung), out);
+    }
+
     bool decodeSamsung(const esp32ir::RxResult &in, esp32ir::payload::Samsung &out)
     {
         out = {};
@@ -12,37 +35,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 4500;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 32, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint16_t>(data >> 16);
-        return true;
+        return decodeSamsung(in.raw.view(), out);
+    }
+    bool decodeSamsung(const esp32ir::ITPSView &raw, esp32ir::payload::Samsung &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeSamsung(pulses.view(), out);
     }
     bool Transmitter::sendSamsung(const esp32ir::payload::Samsung &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 4500;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Samsung, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Samsung));
+        return sendEncoded(codec::encode(codec::kSamsung, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Samsung);
     }
     bool Transmitter::sendSamsung(uint16_t address, uint16_t command)
     {
@@ -50,6 +57,30 @@ namespace esp32ir
         return sendSamsung(p);
     }
 
+#endif // ESP32IR_ENABLE_SAMSUNG
+
+#if ESP32IR_ENABLE_SAMSUNG36
+
+    namespace nec_like
+    {
+        bool decodeSamsung36(const Bits &bits, esp32ir::payload::Samsung36 &out)
+        {
+            if (!bits.has(codec::kSamsung36.maxBits))
+            {
+                return false;
+            }
+            out.raw = bits.take(codec::kSamsung36.maxBits);
+            out.bits = 36;
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeSamsung36(const esp32ir::PulseView &pulses, esp32ir::payload::Samsung36 &out)
+    {
+        out = {};
+        return nec_like::decodeSamsung36(nec_like::extract(pulses, nec_like::Family::Samsung), out);
+    }
+
     bool decodeSamsung36(const esp32ir::RxResult &in, esp32ir::payload::Samsung36 &out)
     {
         out = {};
@@ -57,29 +88,16 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 4500;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 36, data))
-        {
-            return false;
-        }
-        out.raw = data & ((1ULL << 36) - 1);
-        out.bits = 36;
-        return true;
+        return decodeSamsung36(in.raw.view(), out);
+    }
+    bool decodeSamsung36(const esp32ir::ITPSView &raw, esp32ir::payload::Samsung36 &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeSamsung36(pulses.view(), out);
     }
     bool Transmitter::sendSamsung36(const esp32ir::payload::Samsung36 &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 4500;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-
         esp32ir::payload::Samsung36 fixed = p;
         uint8_t bits = fixed.bits ? fixed.bits : 36;
         if (bits != 36)
@@ -87,14 +105,11 @@ namespace esp32ir
         fixed.bits = bits;
         fixed.raw &= ((1ULL << bits) - 1);
 
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Samsung36, reinterpret_cast<const uint8_t *>(&fixed), static_cast<uint16_t>(sizeof(fixed)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Samsung36));
+        return sendEncoded(codec::encode(codec::kSamsung36, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Samsung36);
     }
     bool Transmitter::sendSamsung36(uint64_t raw, uint8_t bits)
     {
@@ -102,4 +117,6 @@ namespace esp32ir
         return sendSamsung36(p);
     }
 
+#endif // ESP32IR_ENABLE_SAMSUNG36
+
 } // namespace esp32ir
@@ -1,7 +1,7 @@
 #include "ESP32IRPulseCodec.h"
 #include "core/message_utils.h"
-#include "core/itps_encode.h"
 #include "core/pulse_utils.h"
+#include "descriptors.h"
 #include <esp_log.h>
 #include <vector>
 
@@ -21,124 +21,44 @@ namespace esp32ir
             esp32ir::RxSplitPolicy::DROP_GAP};
     }
 
-    namespace
-    {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kStartMarkUs = 2400;
-        constexpr uint32_t kStartSpaceUs = 600;
-        constexpr uint32_t kBitSpaceUs = 600;
-        constexpr uint32_t kBitMark0Us = 600;
-        constexpr uint32_t kBitMark1Us = 1200;
-        constexpr uint32_t kBitThresholdUs = (kBitMark0Us + kBitMark1Us) / 2;
-
-        void appendMark(std::vector<int8_t> &seq, uint32_t us)
-        {
-            itps_encode::appendPulse(seq, true, us, kTUs);
-        }
-        void appendSpace(std::vector<int8_t> &seq, uint32_t us)
-        {
-            itps_encode::appendPulse(seq, false, us, kTUs);
-        }
+#if ESP32IR_ENABLE_SONY
 
-        esp32ir::ITPSBuffer buildSONYFromTxBits(const std::vector<uint8_t> &txBytes, uint16_t bitCount)
+    bool decodeSONY(const esp32ir::PulseView &pulses, esp32ir::payload::SONY &out)
+    {
+        out = {};
+        codec::Bits bits = codec::extract<codec::kSONY>(pulses);
+        if (!bits.header)
+            return false;
+        // Try longer formats first to avoid misclassifying 15/20-bit frames as 12-bit.
+        for (uint8_t n : {20, 15, 12})
         {
-            std::vector<int8_t> seq;
-            seq.reserve(128);
-
-            appendMark(seq, kStartMarkUs);
-            appendSpace(seq, kStartSpaceUs);
-
-            for (uint16_t i = 0; i < bitCount; ++i)
+            // Bit n-1 may end the frame (no space, or a long gap) but not with a short/odd space.
+            if (bits.count > n || (bits.count == n && bits.stop != codec::Stop::Space))
             {
-                bool one = (txBytes[i / 8] >> (i % 8)) & 0x1;
-                appendMark(seq, one ? kBitMark1Us : kBitMark0Us);
-                appendSpace(seq, kBitSpaceUs);
+                uint32_t data = static_cast<uint32_t>(bits.take(n));
+                out.address = static_cast<uint16_t>(data >> 7);
+                out.command = static_cast<uint16_t>(data & 0x7F);
+                out.bits = n;
+                return true;
             }
-
-            esp32ir::ITPSFrame frame{kTUs, static_cast<uint16_t>(seq.size()), seq.data(), 0};
-            esp32ir::ITPSBuffer buf;
-            buf.addFrame(frame);
-            return buf;
         }
-    } // namespace
+        return false;
+    }
 
     bool decodeSONY(const esp32ir::RxResult &in, esp32ir::payload::SONY &out)
     {
         out = {};
         if (decodeMessage(in, esp32ir::Protocol::SONY, out))
-            return true;
-        std::vector<esp32ir::Pulse> pulses;
-        if (!esp32ir::collectPulses(in.raw, pulses))
-        {
-            return false;
-        }
-        // Try longer formats first to avoid misclassifying 15/20-bit frames as 12-bit.
-        for (uint8_t bits : {20, 15, 12})
         {
-            // Allow trailing space of the last bit to be missing (one pulse shorter).
-            uint16_t minPulses = static_cast<uint16_t>(2 + bits * 2 - 1);
-            if (pulses.size() < minPulses)
-                continue;
-            size_t idx = 0;
-            auto ok = [&](bool mark, uint32_t target, uint32_t tol) -> bool
-            {
-                if (idx >= pulses.size())
-                    return false;
-                const auto &p = pulses[idx];
-                if (p.mark != mark || !esp32ir::inRange(p.us, target, tol))
-                    return false;
-                ++idx;
-                return true;
-            };
-            idx = 0;
-            if (!ok(true, kStartMarkUs, 25) || !ok(false, kStartSpaceUs, 35))
-                continue;
-            uint32_t data = 0;
-            bool okBits = true;
-            auto markOk = [&](uint32_t us)
-            {
-                return esp32ir::inRange(us, kBitMark0Us, 35) || esp32ir::inRange(us, kBitMark1Us, 35);
-            };
-            for (uint8_t i = 0; i < bits; ++i)
-            {
-                if (idx >= pulses.size() || !markOk(pulses[idx].us) || !pulses[idx].mark)
-                {
-                    okBits = false;
-                    break;
-                }
-                uint32_t markLen = pulses[idx].us;
-                ++idx;
-                if (idx >= pulses.size())
-                {
-                    if (i != bits - 1)
-                    {
-                        okBits = false;
-                        break;
-                    }
-                    // Last bit without trailing space; accept end-of-frame.
-                    continue;
-                }
-                const auto &spacePulse = pulses[idx];
-                bool spaceOk = esp32ir::inRange(spacePulse.us, kBitSpaceUs, 35);
-                bool finalGapOk = (i == bits - 1) && !spacePulse.mark && spacePulse.us >= kBitSpaceUs;
-                if (spacePulse.mark || (!spaceOk && !finalGapOk))
-                {
-                    okBits = false;
-                    break;
-                }
-                bool one = markLen > kBitThresholdUs;
-                if (one)
-                    data |= (1u << i);
-                ++idx;
-            }
-            if (!okBits)
-                continue;
-            out.address = static_cast<uint16_t>(data >> 7);
-            out.command = static_cast<uint16_t>(data & 0x7F);
-            out.bits = bits;
             return true;
         }
-        return false;
+        return decodeSONY(in.raw.view(), out);
+    }
+    bool decodeSONY(const esp32ir::ITPSView &raw, esp32ir::payload::SONY &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeSONY(pulses.view(), out);
     }
     bool Transmitter::sendSONY(const esp32ir::payload::SONY &p)
     {
@@ -148,12 +68,11 @@ namespace esp32ir
             ESP_LOGE("ESP32IRPulseCodec", "SONY bits must be 12/15/20 (got %u)", static_cast<unsigned>(bits));
             return false;
         }
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::SONY, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        return sendWithGap(buildSONYFromTxBits(txBytes, bitCount), recommendedGapUs(esp32ir::Protocol::SONY));
+        return sendEncoded(codec::encode(codec::kSONY, txBytes_, bitCount, txFrame_), esp32ir::Protocol::SONY);
     }
     bool Transmitter::sendSONY(uint16_t address, uint16_t command, uint8_t bits)
     {
@@ -161,4 +80,6 @@ namespace esp32ir
         return sendSONY(p);
     }
 
+#endif // ESP32IR_ENABLE_SONY
+
 } // namespace esp32ir
@@ -5,6 +5,30 @@
 namespace esp32ir
 {
 
+#if ESP32IR_ENABLE_TOSHIBA
+
+    namespace nec_like
+    {
+        bool decodeToshiba(const Bits &bits, esp32ir::payload::Toshiba &out)
+        {
+            if (!bits.has(codec::kToshiba.maxBits))
+            {
+                return false;
+            }
+            uint64_t data = bits.take(codec::kToshiba.maxBits);
+            out.address = static_cast<uint16_t>(data & 0xFFFF);
+            out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
+            out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
+            return true;
+        }
+    } // namespace nec_like
+
+    bool decodeToshiba(const esp32ir::PulseView &pulses, esp32ir::payload::Toshiba &out)
+    {
+        out = {};
+        return nec_like::decodeToshiba(nec_like::extract(pulses, nec_like::Family::NEC), out);
+    }
+
     bool decodeToshiba(const esp32ir::RxResult &in, esp32ir::payload::Toshiba &out)
     {
         out = {};
@@ -12,37 +36,21 @@ namespace esp32ir
         {
             return true;
         }
-        uint64_t data = 0;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        if (!nec_like::decodeRaw(in, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs, kZeroSpaceUs, kOneSpaceUs, 40, data))
-        {
-            return false;
-        }
-        out.address = static_cast<uint16_t>(data & 0xFFFF);
-        out.command = static_cast<uint16_t>((data >> 16) & 0xFFFF);
-        out.extra = static_cast<uint8_t>((data >> 32) & 0xFF);
-        return true;
+        return decodeToshiba(in.raw.view(), out);
+    }
+    bool decodeToshiba(const esp32ir::ITPSView &raw, esp32ir::payload::Toshiba &out)
+    {
+        out = {};
+        esp32ir::PulseBuffer pulses;
+        return esp32ir::collectPulses(raw, pulses) && decodeToshiba(pulses.view(), out);
     }
     bool Transmitter::sendToshiba(const esp32ir::payload::Toshiba &p)
     {
-        constexpr uint16_t kTUs = 10;
-        constexpr uint32_t kHdrMarkUs = 9000;
-        constexpr uint32_t kHdrSpaceUs = 4500;
-        constexpr uint32_t kBitMarkUs = 560;
-        constexpr uint32_t kZeroSpaceUs = 560;
-        constexpr uint32_t kOneSpaceUs = 1690;
-        std::vector<uint8_t> txBytes;
         uint16_t bitCount = 0;
         esp32ir::ProtocolMessage msg{esp32ir::Protocol::Toshiba, reinterpret_cast<const uint8_t *>(&p), static_cast<uint16_t>(sizeof(p)), 0};
-        if (!esp32ir::buildTxBitstream(msg, txBytes, bitCount) || bitCount == 0)
+        if (!esp32ir::buildTxBitstream(msg, txBytes_, bitCount) || bitCount == 0)
             return false;
-        esp32ir::ITPSBuffer buf = nec_like::buildFromTxBytes(kTUs, kHdrMarkUs, kHdrSpaceUs, kBitMarkUs,
-                                                             kZeroSpaceUs, kOneSpaceUs, txBytes, static_cast<uint8_t>(bitCount), true);
-        return sendWithGap(buf, recommendedGapUs(esp32ir::Protocol::Toshiba));
+        return sendEncoded(codec::encode(codec::kToshiba, txBytes_, bitCount, txFrame_), esp32ir::Protocol::Toshiba);
     }
     bool Transmitter::sendToshiba(uint16_t address, uint16_t command, uint8_t extra)
     {
@@ -50,4 +58,6 @@ namespace esp32ir
         return sendToshiba(p);
     }
 
+#endif // ESP32IR_ENABLE_TOSHIBA
+
 } // namespace esp32ir
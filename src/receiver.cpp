@@ -1,7 +1,24 @@
 #include "ESP32IRPulseCodec.h"
+#include "core/frame_splitter.h"
+#include "core/pulse_utils.h"
+#include "protocols/descriptors.h"
+#include "protocols/nec_like.h"
 #include <driver/rmt_rx.h>
 #include <driver/rmt_types.h>
+#include <esp_cpu.h>
+#include <esp_idf_version.h>
+#include <esp_timer.h>
+#include <soc/soc_caps.h>
 #include <algorithm>
+#include <cstring>
+
+// Partial RX (IDF 5.3+ on targets with RX ping-pong memory): a capture longer than one buffer arrives as
+// several events and is stitched back together, so buffer size no longer limits the frame length.
+#if defined(SOC_RMT_SUPPORT_RX_PINGPONG) && SOC_RMT_SUPPORT_RX_PINGPONG && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define ESP32IR_RX_PARTIAL 1
+#else
+#define ESP32IR_RX_PARTIAL 0
+#endif
 
 namespace esp32ir
 {
@@ -12,6 +29,12 @@ namespace esp32ir
         constexpr uint32_t kRmtRefClockHz = 1000000; // REF_TICK
         constexpr uint32_t kRmtMaxDivider = 256;
         constexpr uint32_t kRmtMinResolutionHz = (kRmtRefClockHz + kRmtMaxDivider - 1) / kRmtMaxDivider;
+        // Receiver::configState_: the slot reconfigure() fills is being written, waits for the consumer, or is being
+        // switched to.
+        constexpr uint8_t kConfigIdle = 0;
+        constexpr uint8_t kConfigWriting = 1;
+        constexpr uint8_t kConfigReady = 2;
+        constexpr uint8_t kConfigApplying = 3;
 
         const char *splitPolicyName(esp32ir::RxSplitPolicy policy)
         {
@@ -26,79 +49,145 @@ namespace esp32ir
             }
         }
 
-        bool rxDoneCallback(rmt_channel_handle_t, const rmt_rx_done_event_data_t *edata, void *user_ctx)
+        // Index of the RMT buffer holding `symbols`, or -1 when it is not one of ours.
+        int bufferIndexOf(const esp32ir::Receiver::RxCallbackContext *ctx, const rmt_symbol_word_t *symbols)
         {
-            auto ctx = static_cast<esp32ir::Receiver::RxCallbackContext *>(user_ctx);
-            if (!ctx || !ctx->queue || !ctx->overflowFlag || !edata)
+            if (!symbols || !ctx->buffers || symbols < ctx->buffers)
             {
-                return false;
+                return -1;
             }
-            BaseType_t high_task_woken = pdFALSE;
-            uint8_t bufIdx = 0xFF;
-            for (uint8_t i = 0; i < 2; ++i)
+            size_t offset = static_cast<size_t>(symbols - ctx->buffers);
+            if (offset % ctx->bufferLenSymbols != 0 || offset / ctx->bufferLenSymbols >= ctx->bufferCount)
             {
-                if (ctx->buffers[i] == edata->received_symbols)
-                {
-                    bufIdx = i;
-                    break;
-                }
+                return -1;
             }
-            if (bufIdx > 1)
+            return static_cast<int>(offset / ctx->bufferLenSymbols);
+        }
+
+        void releaseBuffer(const esp32ir::Receiver::RxCallbackContext *ctx, int bufIdx)
+        {
+            if (bufIdx >= 0)
             {
-                *(ctx->overflowFlag) = true;
+                ctx->pendingMask->fetch_and(~(1u << bufIdx), std::memory_order_release);
             }
-            else
+        }
+
+        // First buffer that is neither queued nor being filled, or -1.
+        int freeBufferIndex(const esp32ir::Receiver::RxCallbackContext *ctx)
+        {
+            uint32_t mask = ctx->pendingMask->load(std::memory_order_acquire);
+            int armed = ctx->armedIndex->load(std::memory_order_relaxed);
+            for (uint8_t i = 0; i < ctx->bufferCount; ++i)
             {
-                uint8_t mask = *(ctx->pendingMask);
-                mask |= static_cast<uint8_t>(1u << bufIdx);
-                *(ctx->pendingMask) = mask;
+                if ((mask & (1u << i)) == 0 && static_cast<int>(i) != armed)
+                {
+                    return static_cast<int>(i);
+                }
             }
-            if (xQueueSendFromISR(ctx->queue, edata, &high_task_woken) != pdTRUE)
+            return -1;
+        }
+
+        // Queue a capture held in buffer ev.buffer, applying the overflow policy when the ring is full.
+        void queueEvent(esp32ir::Receiver::RxCallbackContext *ctx, const esp32ir::RxEventDesc &ev, BaseType_t *high_task_woken)
+        {
+            ctx->eventUs[ev.buffer] = esp_timer_get_time();
+            ctx->pendingMask->fetch_or(1u << ev.buffer, std::memory_order_relaxed);
+            if (!ctx->events->push(ev))
             {
-                // Drop oldest to make room (spec: older entries are dropped on overflow).
-                rmt_rx_done_event_data_t dummy{};
-                xQueueReceiveFromISR(ctx->queue, &dummy, &high_task_woken);
-                if (xQueueSendFromISR(ctx->queue, edata, &high_task_woken) != pdTRUE)
+                // Ring full: dropped captures give their buffer back so reception can continue.
+                switch (ctx->overflowPolicy)
                 {
-                    *(ctx->overflowFlag) = true;
-                }
-                else
+                case esp32ir::RxOverflowPolicy::DROP_OLDEST:
                 {
-                    *(ctx->overflowFlag) = true;
+                    esp32ir::RxEventDesc oldest{};
+                    if (ctx->events->dropOldest(oldest))
+                    {
+                        releaseBuffer(ctx, oldest.buffer);
+                    }
+                    if (!ctx->events->push(ev))
+                    {
+                        releaseBuffer(ctx, ev.buffer);
+                    }
+                    ctx->loss->droppedOldest.fetch_add(1, std::memory_order_relaxed);
+                    ctx->overflowFlag->store(true, std::memory_order_relaxed);
+                    break;
+                }
+                case esp32ir::RxOverflowPolicy::DROP_NEWEST:
+                    releaseBuffer(ctx, ev.buffer);
+                    ctx->loss->droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                    ctx->overflowFlag->store(true, std::memory_order_relaxed);
+                    break;
+                case esp32ir::RxOverflowPolicy::COUNT_ONLY:
+                default:
+                    releaseBuffer(ctx, ev.buffer);
+                    ctx->loss->countedOnly.fetch_add(1, std::memory_order_relaxed);
+                    break;
                 }
             }
-            if (!edata->flags.is_last)
+            if (ctx->wake)
             {
-                *(ctx->overflowFlag) = true;
+                xSemaphoreGiveFromISR(ctx->wake, high_task_woken);
             }
-            // Attempt to re-arm reception using a free buffer
-            int freeIdx = -1;
-            uint8_t mask = *(ctx->pendingMask);
-            for (uint8_t i = 0; i < 2; ++i)
+        }
+
+        bool rxDoneCallback(rmt_channel_handle_t, const rmt_rx_done_event_data_t *edata, void *user_ctx)
+        {
+            auto ctx = static_cast<esp32ir::Receiver::RxCallbackContext *>(user_ctx);
+            if (!ctx || !ctx->events || !edata)
+            {
+                return false;
+            }
+            BaseType_t high_task_woken = pdFALSE;
+            if (!edata->flags.is_last)
             {
-                if ((mask & (1u << i)) == 0 && ctx->buffers[i])
+#if ESP32IR_RX_PARTIAL
+                // Partial RX: the driver keeps filling the same buffer, so queue a copy of this chunk and leave
+                // the channel armed. processEvent() stitches the chunks back into one capture.
+                int copyIdx = freeBufferIndex(ctx);
+                if (copyIdx < 0 || !edata->received_symbols)
                 {
-                    freeIdx = static_cast<int>(i);
-                    break;
+                    ctx->loss->bufferStarved.fetch_add(1, std::memory_order_relaxed);
+                    ctx->overflowFlag->store(true, std::memory_order_relaxed);
+                    return false;
                 }
+                size_t n = std::min(edata->num_symbols, ctx->bufferLenSymbols);
+                std::memcpy(ctx->buffers + static_cast<size_t>(copyIdx) * ctx->bufferLenSymbols, edata->received_symbols, n * sizeof(rmt_symbol_word_t));
+                queueEvent(ctx, {static_cast<uint8_t>(copyIdx), false, static_cast<uint32_t>(n)}, &high_task_woken);
+                return high_task_woken == pdTRUE;
+#else
+                ctx->overflowFlag->store(true, std::memory_order_relaxed);
+#endif
+            }
+            int bufIdx = bufferIndexOf(ctx, edata->received_symbols);
+            if (bufIdx >= 0)
+            {
+                queueEvent(ctx, {static_cast<uint8_t>(bufIdx), edata->flags.is_last != 0, static_cast<uint32_t>(edata->num_symbols)}, &high_task_woken);
+            }
+            else
+            {
+                ctx->overflowFlag->store(true, std::memory_order_relaxed); // not one of our buffers: nothing to hand over
             }
+            // Attempt to re-arm reception using a free buffer
+            ctx->armedIndex->store(-1, std::memory_order_relaxed);
+            int freeIdx = freeBufferIndex(ctx);
             if (freeIdx >= 0 && ctx->channel && ctx->rxConfig)
             {
-                esp_err_t err = rmt_receive(ctx->channel, ctx->buffers[freeIdx], ctx->bufferLenSymbols * sizeof(rmt_symbol_word_t), ctx->rxConfig);
+                esp_err_t err = rmt_receive(ctx->channel, ctx->buffers + static_cast<size_t>(freeIdx) * ctx->bufferLenSymbols, ctx->bufferLenSymbols * sizeof(rmt_symbol_word_t), ctx->rxConfig);
                 if (err != ESP_OK)
                 {
-                    *(ctx->overflowFlag) = true;
-                    if (ctx->needRestart)
-                        *(ctx->needRestart) = true;
+                    ctx->overflowFlag->store(true, std::memory_order_relaxed);
+                    ctx->needRestart->store(true, std::memory_order_release);
                 }
-                else if (ctx->needRestart)
+                else
                 {
-                    *(ctx->needRestart) = false;
+                    ctx->armedIndex->store(freeIdx, std::memory_order_relaxed);
+                    ctx->needRestart->store(false, std::memory_order_release);
                 }
             }
-            else if (ctx->needRestart)
+            else
             {
-                *(ctx->needRestart) = true;
+                ctx->loss->bufferStarved.fetch_add(1, std::memory_order_relaxed);
+                ctx->needRestart->store(true, std::memory_order_release);
             }
             return high_task_woken == pdTRUE;
         }
@@ -118,43 +207,92 @@ namespace esp32ir
             }
         }
 
-        std::vector<esp32ir::Protocol> allKnownProtocols()
+        const std::vector<esp32ir::Protocol> &allKnownProtocols()
         {
-            return {
+            // Only the codecs compiled in (esp32irpulsecodec_config.h), in decode order.
+            static const std::vector<esp32ir::Protocol> kAll = {
+#if ESP32IR_ENABLE_NEC
                 esp32ir::Protocol::NEC,
+#endif
+#if ESP32IR_ENABLE_SONY
                 esp32ir::Protocol::SONY,
+#endif
+#if ESP32IR_ENABLE_AEHA
                 esp32ir::Protocol::AEHA,
+#endif
+#if ESP32IR_ENABLE_PANASONIC
                 esp32ir::Protocol::Panasonic,
+#endif
+#if ESP32IR_ENABLE_JVC
                 esp32ir::Protocol::JVC,
+#endif
+#if ESP32IR_ENABLE_SAMSUNG36
                 esp32ir::Protocol::Samsung36,
+#endif
+#if ESP32IR_ENABLE_SAMSUNG
                 esp32ir::Protocol::Samsung,
+#endif
+#if ESP32IR_ENABLE_LG
                 esp32ir::Protocol::LG,
+#endif
+#if ESP32IR_ENABLE_DENON
                 esp32ir::Protocol::Denon,
+#endif
+#if ESP32IR_ENABLE_RC5
                 esp32ir::Protocol::RC5,
+#endif
+#if ESP32IR_ENABLE_RC6
                 esp32ir::Protocol::RC6,
+#endif
+#if ESP32IR_ENABLE_APPLE
                 esp32ir::Protocol::Apple,
+#endif
+#if ESP32IR_ENABLE_PIONEER
                 esp32ir::Protocol::Pioneer,
+#endif
+#if ESP32IR_ENABLE_TOSHIBA
                 esp32ir::Protocol::Toshiba,
+#endif
+#if ESP32IR_ENABLE_MITSUBISHI
                 esp32ir::Protocol::Mitsubishi,
+#endif
+#if ESP32IR_ENABLE_HITACHI
                 esp32ir::Protocol::Hitachi,
+#endif
+#if ESP32IR_ENABLE_DAIKINAC
                 esp32ir::Protocol::DaikinAC,
+#endif
+#if ESP32IR_ENABLE_PANASONICAC
                 esp32ir::Protocol::PanasonicAC,
+#endif
+#if ESP32IR_ENABLE_MITSUBISHIAC
                 esp32ir::Protocol::MitsubishiAC,
+#endif
+#if ESP32IR_ENABLE_TOSHIBAAC
                 esp32ir::Protocol::ToshibaAC,
-                esp32ir::Protocol::FujitsuAC};
+#endif
+#if ESP32IR_ENABLE_FUJITSUAC
+                esp32ir::Protocol::FujitsuAC,
+#endif
+            };
+            return kAll;
         }
 
-        std::vector<esp32ir::Protocol> knownWithoutAC()
+        const std::vector<esp32ir::Protocol> &knownWithoutAC()
         {
-            std::vector<esp32ir::Protocol> v;
-            for (auto p : allKnownProtocols())
+            static const std::vector<esp32ir::Protocol> kNoAC = []
             {
-                if (!isACProtocol(p))
+                std::vector<esp32ir::Protocol> v;
+                for (auto p : allKnownProtocols())
                 {
-                    v.push_back(p);
+                    if (!isACProtocol(p))
+                    {
+                        v.push_back(p);
+                    }
                 }
-            }
-            return v;
+                return v;
+            }();
+            return kNoAC;
         }
 
         void dedupAppend(std::vector<esp32ir::Protocol> &list, esp32ir::Protocol p)
@@ -280,6 +418,138 @@ namespace esp32ir
             }
         }
 
+        // Window accepted by inRange(v, target, tolPercent).
+        constexpr uint32_t lowerUs(uint32_t target, uint32_t tolPercent) { return target - target * tolPercent / 100; }
+        constexpr uint32_t upperUs(uint32_t target, uint32_t tolPercent) { return target + target * tolPercent / 100; }
+
+        struct HeaderWindow
+        {
+            uint32_t markLo;
+            uint32_t markHi;
+            uint32_t spaceLo;
+            uint32_t spaceHi;
+            bool balanced;
+        };
+
+        // First mark/space window a decoder with descriptor d requires before it looks at any bit: the header
+        // (and repeat-code space) at the descriptor's tolerances. Biphase codecs have no fixed header.
+        constexpr HeaderWindow headerWindowOf(const codec::ProtocolDescriptor &d)
+        {
+            if (d.encoding == codec::BitEncoding::Biphase)
+            {
+                return {0, UINT32_MAX, 0, UINT32_MAX, true};
+            }
+            HeaderWindow w{lowerUs(d.headerMarkUs, d.headerMarkTolPct), upperUs(d.headerMarkUs, d.headerMarkTolPct),
+                           lowerUs(d.headerSpaceUs, d.headerSpaceTolPct), upperUs(d.headerSpaceUs, d.headerSpaceTolPct), false};
+            if (d.repeatSpaceUs != 0)
+            {
+                w.spaceLo = std::min(w.spaceLo, lowerUs(d.repeatSpaceUs, d.repeatTolPct));
+                w.spaceHi = std::max(w.spaceHi, upperUs(d.repeatSpaceUs, d.repeatTolPct));
+            }
+            return w;
+        }
+
+        // A frame outside the window of p skips that decoder.
+        bool headerWindow(esp32ir::Protocol p, HeaderWindow &route)
+        {
+            switch (p)
+            {
+            case esp32ir::Protocol::NEC:
+                route = headerWindowOf(codec::kNEC);
+                return true;
+            case esp32ir::Protocol::Denon:
+                route = headerWindowOf(codec::kDenon);
+                return true;
+            case esp32ir::Protocol::LG:
+                route = headerWindowOf(codec::kLG);
+                return true;
+            case esp32ir::Protocol::Apple:
+                route = headerWindowOf(codec::kApple);
+                return true;
+            case esp32ir::Protocol::Pioneer:
+                route = headerWindowOf(codec::kPioneer);
+                return true;
+            case esp32ir::Protocol::Toshiba:
+                route = headerWindowOf(codec::kToshiba);
+                return true;
+            case esp32ir::Protocol::Mitsubishi:
+                route = headerWindowOf(codec::kMitsubishi);
+                return true;
+            case esp32ir::Protocol::Hitachi:
+                route = headerWindowOf(codec::kHitachi);
+                return true;
+            case esp32ir::Protocol::Samsung:
+                route = headerWindowOf(codec::kSamsung);
+                return true;
+            case esp32ir::Protocol::Samsung36:
+                route = headerWindowOf(codec::kSamsung36);
+                return true;
+            case esp32ir::Protocol::JVC:
+                route = headerWindowOf(codec::kJVC);
+                return true;
+            case esp32ir::Protocol::Panasonic:
+                route = headerWindowOf(codec::kPanasonic);
+                return true;
+            case esp32ir::Protocol::AEHA:
+                route = headerWindowOf(codec::kAEHA);
+                return true;
+            case esp32ir::Protocol::SONY:
+                route = headerWindowOf(codec::kSONY);
+                return true;
+            case esp32ir::Protocol::RC5:
+                route = headerWindowOf(codec::kRC5);
+                return true;
+            case esp32ir::Protocol::RC6:
+                route = headerWindowOf(codec::kRC6);
+                return true;
+            default:
+                return false; // AC protocols have no receive decoder
+            }
+        }
+
+        // Silence after which a frame of p is complete: its longest mark/space (upper tolerance bound).
+        // 0 when p needs the frame gap (AC messages span several frames in one capture).
+        uint32_t frameEndIdleUs(esp32ir::Protocol p)
+        {
+            switch (p)
+            {
+            case esp32ir::Protocol::NEC:
+                return codec::longestSymbolUs(codec::kNEC);
+            case esp32ir::Protocol::Denon:
+                return codec::longestSymbolUs(codec::kDenon);
+            case esp32ir::Protocol::LG:
+                return codec::longestSymbolUs(codec::kLG);
+            case esp32ir::Protocol::Apple:
+                return codec::longestSymbolUs(codec::kApple);
+            case esp32ir::Protocol::Pioneer:
+                return codec::longestSymbolUs(codec::kPioneer);
+            case esp32ir::Protocol::Toshiba:
+                return codec::longestSymbolUs(codec::kToshiba);
+            case esp32ir::Protocol::Mitsubishi:
+                return codec::longestSymbolUs(codec::kMitsubishi);
+            case esp32ir::Protocol::Hitachi:
+                return codec::longestSymbolUs(codec::kHitachi);
+            case esp32ir::Protocol::Samsung:
+                return codec::longestSymbolUs(codec::kSamsung);
+            case esp32ir::Protocol::Samsung36:
+                return codec::longestSymbolUs(codec::kSamsung36);
+            case esp32ir::Protocol::JVC:
+                return codec::longestSymbolUs(codec::kJVC);
+            case esp32ir::Protocol::Panasonic:
+                return codec::longestSymbolUs(codec::kPanasonic);
+            case esp32ir::Protocol::AEHA:
+                return codec::longestSymbolUs(codec::kAEHA);
+            case esp32ir::Protocol::SONY:
+                return codec::longestSymbolUs(codec::kSONY);
+            case esp32ir::Protocol::RC5:
+                return codec::longestSymbolUs(codec::kRC5);
+            case esp32ir::Protocol::RC6:
+                return codec::longestSymbolUs(codec::kRC6);
+            default:
+                return 0;
+            }
+        }
+
     } // namespace
 
     Receiver::Receiver() = default;
@@ -311,52 +581,271 @@ namespace esp32ir
     {
         if (begun_)
             return false;
-        frameGapUs_ = frameGapUs;
+        config_.frameGapUs = frameGapUs;
         return true;
     }
     bool Receiver::setHardGapUs(uint32_t hardGapUs)
     {
         if (begun_)
             return false;
-        hardGapUs_ = hardGapUs;
+        config_.hardGapUs = hardGapUs;
         return true;
     }
     bool Receiver::setMinFrameUs(uint32_t minFrameUs)
     {
         if (begun_)
             return false;
-        minFrameUs_ = minFrameUs;
+        config_.minFrameUs = minFrameUs;
         return true;
     }
     bool Receiver::setMaxFrameUs(uint32_t maxFrameUs)
     {
         if (begun_)
             return false;
-        maxFrameUs_ = maxFrameUs;
+        config_.maxFrameUs = maxFrameUs;
         return true;
     }
     bool Receiver::setMinEdges(uint16_t minEdges)
     {
         if (begun_)
             return false;
-        minEdges_ = minEdges;
+        config_.minEdges = minEdges;
         return true;
     }
     bool Receiver::setFrameCountMax(uint16_t frameCountMax)
     {
         if (begun_)
             return false;
-        frameCountMax_ = frameCountMax;
+        config_.frameCountMax = frameCountMax;
         return true;
     }
     bool Receiver::setSplitPolicy(RxSplitPolicy policy)
     {
         if (begun_)
             return false;
-        splitPolicy_ = policy;
-        splitPolicySet_ = true;
+        config_.splitPolicy = policy;
+        config_.splitPolicySet = true;
+        return true;
+    }
+    bool Receiver::setLowLatency(bool enable)
+    {
+        if (begun_)
+            return false;
+        lowLatency_ = enable;
+        return true;
+    }
+    bool Receiver::setGlitchFilterUs(uint32_t glitchUs)
+    {
+        if (begun_)
+            return false;
+        config_.glitchFilterUs = glitchUs;
+        return true;
+    }
+    bool Receiver::setZeroAlloc(bool enable)
+    {
+        if (begun_)
+            return false;
+        zeroAlloc_ = enable;
+        return true;
+    }
+    uint32_t Receiver::heapAllocCount() const
+    {
+        return heapAllocCount_.load(std::memory_order_relaxed);
+    }
+    bool Receiver::setRxBufferCount(uint8_t count)
+    {
+        if (begun_ || count == 0 || count > 32)
+            return false;
+        rxBufferCount_ = count;
+        return true;
+    }
+    bool Receiver::setRxBufferSymbols(size_t symbols)
+    {
+        if (begun_ || symbols == 0 || symbols > esp32ir::RxEventDesc::kMaxSymbols)
+            return false;
+        rxBufferSymbols_ = symbols;
+        return true;
+    }
+    bool Receiver::setArenaSymbols(size_t symbols)
+    {
+        if (begun_)
+            return false;
+        arenaSymbols_ = symbols;
+        return true;
+    }
+    bool Receiver::setEventQueueDepth(uint16_t depth)
+    {
+        if (begun_ || depth == 0)
+            return false;
+        rxEventQueueDepth_ = depth;
+        return true;
+    }
+    bool Receiver::setOverflowPolicy(RxOverflowPolicy policy)
+    {
+        if (begun_)
+            return false;
+        overflowPolicy_ = policy;
+        return true;
+    }
+    RxLossCounters Receiver::lossCounters() const
+    {
+        return {rxLoss_.droppedOldest.load(std::memory_order_relaxed), rxLoss_.droppedNewest.load(std::memory_order_relaxed),
+                rxLoss_.countedOnly.load(std::memory_order_relaxed), rxLoss_.bufferStarved.load(std::memory_order_relaxed)};
+    }
+    void Receiver::resetLossCounters()
+    {
+        rxLoss_.droppedOldest.store(0, std::memory_order_relaxed);
+        rxLoss_.droppedNewest.store(0, std::memory_order_relaxed);
+        rxLoss_.countedOnly.store(0, std::memory_order_relaxed);
+        rxLoss_.bufferStarved.store(0, std::memory_order_relaxed);
+    }
+    rmt_symbol_word_t *Receiver::rxBuffer(size_t index)
+    {
+        return rxBuffers_.data() + index * rxBufferSymbols_;
+    }
+    void Receiver::releaseEventRing()
+    {
+        rxEvents_.release();
+        if (rxWake_)
+        {
+            vSemaphoreDelete(rxWake_);
+            rxWake_ = nullptr;
+        }
+    }
+    bool Receiver::takeEvent(rmt_rx_done_event_data_t &ev)
+    {
+        esp32ir::RxEventDesc desc{};
+        if (!rxEvents_.pop(desc))
+        {
+            return false;
+        }
+        ev = {};
+        ev.received_symbols = rxBuffer(desc.buffer);
+        ev.num_symbols = desc.symbols;
+        ev.flags.is_last = desc.last ? 1 : 0;
+        return true;
+    }
+    bool Receiver::peekEventUs(int64_t &us) const
+    {
+        esp32ir::RxEventDesc desc{};
+        if (!rxEvents_.peek(desc) || desc.buffer >= rxEventUs_.size())
+        {
+            return false;
+        }
+        us = rxEventUs_[desc.buffer];
+        return true;
+    }
+    bool Receiver::useDecodeTask(int core, uint8_t priority, uint32_t stackBytes)
+    {
+        if (begun_)
+            return false;
+        decodeTaskEnabled_ = true;
+        decodeTaskCore_ = core;
+        decodeTaskPriority_ = priority;
+        decodeTaskStackBytes_ = stackBytes;
+        return true;
+    }
+    bool Receiver::setResultQueueDepth(uint16_t depth)
+    {
+        if (begun_ || depth == 0)
+            return false;
+        resultQueueDepth_ = depth;
+        return true;
+    }
+    uint32_t Receiver::droppedResultCount() const
+    {
+        return droppedResults_.load(std::memory_order_relaxed);
+    }
+    bool Receiver::onReceive(RxHandler handler, void *user)
+    {
+        if (begun_ || !handler)
+            return false;
+        subscribers_.push_back({handler, user, false, esp32ir::Protocol::RAW});
+        return true;
+    }
+    bool Receiver::onReceive(esp32ir::Protocol protocol, RxHandler handler, void *user)
+    {
+        if (begun_ || !handler)
+            return false;
+        subscribers_.push_back({handler, user, true, protocol});
+        return true;
+    }
+    bool Receiver::clearReceiveHandlers()
+    {
+        if (begun_)
+            return false;
+        subscribers_.clear();
         return true;
     }
+    RxDeliveryLatency Receiver::deliveryLatency() const
+    {
+        return {latencyLastUs_.load(std::memory_order_relaxed), latencyMaxUs_.load(std::memory_order_relaxed),
+                latencySamples_.load(std::memory_order_relaxed)};
+    }
+    void Receiver::resetDeliveryLatency()
+    {
+        latencyLastUs_ = 0;
+        latencyMaxUs_ = 0;
+        latencySamples_ = 0;
+    }
+    RxLatencyHistogram Receiver::latencyHistogram() const
+    {
+        RxLatencyHistogram h{};
+        for (size_t i = 0; i < RxLatencyHistogram::kBuckets; ++i)
+        {
+            h.queued[i] = histQueued_[i].load(std::memory_order_relaxed);
+            h.decode[i] = histDecode_[i].load(std::memory_order_relaxed);
+        }
+        return h;
+    }
+    void Receiver::resetLatencyHistogram()
+    {
+        for (size_t i = 0; i < RxLatencyHistogram::kBuckets; ++i)
+        {
+            histQueued_[i] = 0;
+            histDecode_[i] = 0;
+        }
+    }
+    RxStats Receiver::stats() const
+    {
+        RxStats st{};
+        st.rmtEvents = stats_.rmtEvents.load(std::memory_order_relaxed);
+        st.symbols = stats_.symbols.load(std::memory_order_relaxed);
+        st.framesSplit = stats_.framesSplit.load(std::memory_order_relaxed);
+        st.framesNoise = stats_.framesNoise.load(std::memory_order_relaxed);
+        st.glitches = stats_.glitches.load(std::memory_order_relaxed);
+        st.decodeMisses = stats_.decodeMisses.load(std::memory_order_relaxed);
+        st.truncations = stats_.truncations.load(std::memory_order_relaxed);
+        st.overflows = stats_.overflows.load(std::memory_order_relaxed);
+        st.restarts = stats_.restarts.load(std::memory_order_relaxed);
+        RxLossCounters loss = lossCounters();
+        st.queueDrops = loss.droppedOldest + loss.droppedNewest + loss.countedOnly + droppedResultCount();
+        for (size_t i = 0; i < RxStats::kProtocols; ++i)
+        {
+            st.decoded[i] = stats_.decoded[i].load(std::memory_order_relaxed);
+            st.decodeCycles[i] = stats_.decodeCycles[i].load(std::memory_order_relaxed);
+        }
+        return st;
+    }
+    void Receiver::resetStats()
+    {
+        stats_.rmtEvents = 0;
+        stats_.symbols = 0;
+        stats_.framesSplit = 0;
+        stats_.framesNoise = 0;
+        stats_.glitches = 0;
+        stats_.decodeMisses = 0;
+        stats_.truncations = 0;
+        stats_.overflows = 0;
+        stats_.restarts = 0;
+        for (size_t i = 0; i < RxStats::kProtocols; ++i)
+        {
+            stats_.decoded[i] = 0;
+            stats_.decodeCycles[i] = 0;
+        }
+        resetLossCounters();
+        droppedResults_ = 0;
+    }
 
     bool Receiver::begin()
     {
@@ -410,77 +899,83 @@ namespace esp32ir
             rxChannel_ = nullptr;
             return false;
         }
-        rxQueue_ = xQueueCreate(8, sizeof(rmt_rx_done_event_data_t));
-        if (!rxQueue_)
+        rxWake_ = xSemaphoreCreateBinary();
+        if (!rxEvents_.init(rxEventQueueDepth_) || !rxWake_)
         {
-            ESP_LOGE(kTag, "RX begin failed: queue create");
+            ESP_LOGE(kTag, "RX begin failed: event ring");
+            releaseEventRing();
             rmt_del_channel(rxChannel_);
             rxChannel_ = nullptr;
             return false;
         }
         rxPendingMask_ = 0;
         rxNeedRestart_ = false;
-        rxBuffers_[0].assign(rxBufferSymbols_, {});
-        rxBuffers_[1].assign(rxBufferSymbols_, {});
+        rxArmedIndex_ = -1;
+        wakeUs_ = 0;
+        resetStats();
+        resetDeliveryLatency();
+        resetLatencyHistogram();
+        rxBuffers_.assign(static_cast<size_t>(rxBufferCount_) * rxBufferSymbols_, {});
+        rxEventUs_.assign(rxBufferCount_, 0);
         rxCallbackCtx_ = {};
-        rxCallbackCtx_.queue = rxQueue_;
+        rxCallbackCtx_.events = &rxEvents_;
+        rxCallbackCtx_.wake = groupWake_ ? groupWake_ : rxWake_;
         rxCallbackCtx_.overflowFlag = &rxOverflowed_;
-        rxCallbackCtx_.buffers[0] = rxBuffers_[0].data();
-        rxCallbackCtx_.buffers[1] = rxBuffers_[1].data();
+        rxCallbackCtx_.buffers = rxBuffers_.data();
+        rxCallbackCtx_.bufferCount = rxBufferCount_;
         rxCallbackCtx_.bufferLenSymbols = rxBufferSymbols_;
         rxCallbackCtx_.pendingMask = &rxPendingMask_;
+        rxCallbackCtx_.overflowPolicy = overflowPolicy_;
+        rxCallbackCtx_.loss = &rxLoss_;
         rxCallbackCtx_.rxConfig = &rxConfig_;
         rxCallbackCtx_.channel = rxChannel_;
         rxCallbackCtx_.needRestart = &rxNeedRestart_;
+        rxCallbackCtx_.armedIndex = &rxArmedIndex_;
+        rxCallbackCtx_.eventUs = rxEventUs_.data();
         rmt_rx_event_callbacks_t cbs = {
             .on_recv_done = rxDoneCallback,
         };
         if (rmt_rx_register_event_callbacks(rxChannel_, &cbs, &rxCallbackCtx_) != ESP_OK)
         {
             ESP_LOGE(kTag, "RX begin failed: register callbacks");
-            vQueueDelete(rxQueue_);
-            rxQueue_ = nullptr;
+            releaseEventRing();
             rmt_del_channel(rxChannel_);
             rxChannel_ = nullptr;
             return false;
         }
-        // Resolve effective RX parameters once at begin (per spec).
-        RxParams params = defaultParams(useRawOnly_ || useRawPlusKnown_);
-        if (!useRawOnly_)
+        // Resolve effective RX parameters once at begin (per spec); reconfigure() resolves later sets the same way.
+        configState_ = kConfigIdle;
+        activeConfig_ = 0;
+        ActiveConfig &cfg = configs_[0];
+        resolveConfig(config_, cfg);
+        configResolved_ = true;
+        uint32_t frameEndUs = 0; // low latency: silence that completes a frame of every enabled protocol
+        if (lowLatency_ && !cfg.rawOnly && !cfg.rawPlusKnown)
         {
-            const auto &plist = protocols_.empty() ? (useKnownNoAC_ ? knownWithoutAC() : allKnownProtocols()) : protocols_;
-            for (auto proto : plist)
+            for (auto proto : cfg.protocols)
             {
-                mergeParams(params, recommendedParamsForProtocol(proto));
+                uint32_t us = frameEndIdleUs(proto);
+                if (us == 0)
+                {
+                    frameEndUs = 0;
+                    break;
+                }
+                frameEndUs = std::max(frameEndUs, us);
             }
         }
-        if (frameGapUs_ > 0)
-            params.frameGapUs = frameGapUs_;
-        if (hardGapUs_ > 0)
-            params.hardGapUs = hardGapUs_;
-        if (minFrameUs_ > 0)
-            params.minFrameUs = minFrameUs_;
-        if (maxFrameUs_ > 0)
-            params.maxFrameUs = maxFrameUs_;
-        if (minEdges_ > 0)
-            params.minEdges = minEdges_;
-        if (frameCountMax_ > 0)
-            params.frameCountMax = frameCountMax_;
-        if (splitPolicySet_)
-            params.splitPolicy = splitPolicy_;
-
-        effFrameGapUs_ = params.frameGapUs;
-        effHardGapUs_ = params.hardGapUs;
-        effMinFrameUs_ = params.minFrameUs;
-        effMaxFrameUs_ = params.maxFrameUs;
-        effMinEdges_ = params.minEdges;
-        effFrameCountMax_ = params.frameCountMax;
-        effSplitPolicy_ = params.splitPolicy;
+        if (lowLatency_ && frameEndUs == 0)
+        {
+            ESP_LOGW(kTag, "RX low latency ignored: RAW modes and AC protocols need the frame gap");
+        }
+        pulseMode_ = !cfg.rawOnly && !cfg.rawPlusKnown;
+        setupArena();
 
         // RMT symbol range: set max to the longest expected mark/space among merged params (capped by RMT limit).
-        uint32_t maxSymbolUs = std::max(effFrameGapUs_, effHardGapUs_);
+        uint32_t maxSymbolUs = std::max(cfg.params.frameGapUs, cfg.params.hardGapUs);
         if (maxSymbolUs == 0)
             maxSymbolUs = 20000; // fallback to default hardGap
+        if (frameEndUs > 0 && frameEndUs < maxSymbolUs)
+            maxSymbolUs = frameEndUs; // end the capture once the frame structure is complete, not after the gap
         // Hardware tick upper limit scales with resolution; base is ~65.5ms at 1us ticks.
         const uint64_t kRmtBaseMaxNs = 65000000ULL; // at 1us resolution
         uint64_t desiredMaxNs = static_cast<uint64_t>(maxSymbolUs) * 1000ULL;
@@ -489,53 +984,54 @@ namespace esp32ir
             desiredMaxNs = scaledMaxNs;
         rxConfig_.signal_range_min_ns = 1000;
         rxConfig_.signal_range_max_ns = desiredMaxNs;
-        if (rmt_receive(rxChannel_, rxBuffers_[0].data(), rxBufferSymbols_ * sizeof(rmt_symbol_word_t), &rxConfig_) != ESP_OK)
+#if ESP32IR_RX_PARTIAL
+        rxConfig_.flags.en_partial_rx = 1;
+#endif
+        rxArmedIndex_ = 0;
+        if (rmt_receive(rxChannel_, rxBuffer(0), rxBufferSymbols_ * sizeof(rmt_symbol_word_t), &rxConfig_) != ESP_OK)
         {
             ESP_LOGE(kTag, "RX begin failed: rmt_receive");
-            vQueueDelete(rxQueue_);
-            rxQueue_ = nullptr;
+            releaseEventRing();
             rmt_del_channel(rxChannel_);
             rxChannel_ = nullptr;
             return false;
         }
 
-        if (!useRawOnly_)
+        if (decodeTaskEnabled_ && !startDecodeTask())
         {
-            if (protocols_.empty())
-            {
-                protocols_ = useKnownNoAC_ ? knownWithoutAC() : allKnownProtocols();
-            }
-            else if (useKnownNoAC_)
-            {
-                std::vector<esp32ir::Protocol> filtered;
-                for (auto p : protocols_)
-                {
-                    if (!isACProtocol(p))
-                    {
-                        dedupAppend(filtered, p);
-                    }
-                }
-                protocols_.swap(filtered);
-            }
+            ESP_LOGE(kTag, "RX begin failed: decode task");
+            rmt_disable(rxChannel_);
+            rmt_del_channel(rxChannel_);
+            rxChannel_ = nullptr;
+            releaseEventRing();
+            return false;
         }
 
-        const char *modeStr = useRawOnly_ ? "RAW_ONLY" : (useRawPlusKnown_ ? "RAW_PLUS_KNOWN" : (useKnownNoAC_ ? "KNOWN_NO_AC" : "KNOWN_ONLY"));
-        ESP_LOGD(kTag, "RX init version=%s pin=%d invert=%s T_us=%u mode=%s frameGapUs=%u hardGapUs=%u minFrameUs=%u maxFrameUs=%u minEdges=%u frameCountMax=%u splitPolicy=%s protocols=%u",
+        const char *modeStr = cfg.rawOnly ? "RAW_ONLY" : (cfg.rawPlusKnown ? "RAW_PLUS_KNOWN" : (cfg.knownWithoutAC ? "KNOWN_NO_AC" : "KNOWN_ONLY"));
+        ESP_LOGD(kTag, "RX init version=%s pin=%d invert=%s T_us=%u mode=%s frameGapUs=%u hardGapUs=%u minFrameUs=%u maxFrameUs=%u minEdges=%u frameCountMax=%u splitPolicy=%s idleUs=%u protocols=%u zeroAlloc=%s arena=%u%s buffers=%ux%u queue=%u overflowPolicy=%u",
                  ESP32IRPULSECODEC_VERSION_STR,
                  rxPin_, invertInput_ ? "true" : "false", static_cast<unsigned>(quantizeT_),
                  modeStr,
-                 static_cast<unsigned>(effFrameGapUs_),
-                 static_cast<unsigned>(effHardGapUs_),
-                 static_cast<unsigned>(effMinFrameUs_),
-                 static_cast<unsigned>(effMaxFrameUs_),
-                 static_cast<unsigned>(effMinEdges_),
-                 static_cast<unsigned>(effFrameCountMax_),
-                 splitPolicyName(effSplitPolicy_),
-                 static_cast<unsigned>(protocols_.size()));
+                 static_cast<unsigned>(cfg.params.frameGapUs),
+                 static_cast<unsigned>(cfg.params.hardGapUs),
+                 static_cast<unsigned>(cfg.params.minFrameUs),
+                 static_cast<unsigned>(cfg.params.maxFrameUs),
+                 static_cast<unsigned>(cfg.params.minEdges),
+                 static_cast<unsigned>(cfg.params.frameCountMax),
+                 splitPolicyName(cfg.params.splitPolicy),
+                 static_cast<unsigned>(rxConfig_.signal_range_max_ns / 1000),
+                 static_cast<unsigned>(cfg.protocols.size()),
+                 zeroAlloc_ ? "true" : "false",
+                 static_cast<unsigned>(pulseMode_ ? arena_->pulses.size() : arena_->pool.size()),
+                 pulseMode_ ? " pulses" : "",
+                 static_cast<unsigned>(rxBufferCount_),
+                 static_cast<unsigned>(rxBufferSymbols_),
+                 static_cast<unsigned>(rxEventQueueDepth_),
+                 static_cast<unsigned>(overflowPolicy_));
         begun_ = true;
-        ESP_LOGI(kTag, "RX begin: pin=%d invert=%s T_us=%u mode=%s",
+        ESP_LOGI(kTag, "RX begin: pin=%d invert=%s T_us=%u mode=%s decodeTask=%s",
                  rxPin_, invertInput_ ? "true" : "false", static_cast<unsigned>(quantizeT_),
-                 modeStr);
+                 modeStr, decodeTask_ ? "true" : "false");
         return true;
     }
     void Receiver::end()
@@ -544,18 +1040,19 @@ namespace esp32ir
         {
             return;
         }
+        stopDecodeTask();
         if (rxChannel_)
         {
             rmt_disable(rxChannel_);
             rmt_del_channel(rxChannel_);
             rxChannel_ = nullptr;
         }
-        if (rxQueue_)
+        releaseEventRing();
+        if (arena_ == &ownArena_)
         {
-            vQueueDelete(rxQueue_);
-            rxQueue_ = nullptr;
+            ownArena_ = RxArena(); // a group's shared arena is released by the group
         }
-        pendingSegments_.clear();
+        pulseMode_ = false;
         rxOverflowed_ = false;
         begun_ = false;
         ESP_LOGI(kTag, "RX end");
@@ -565,119 +1062,216 @@ namespace esp32ir
     {
         if (begun_)
             return false;
-        dedupAppend(protocols_, protocol);
+        if (!esp32ir::protocolEnabled(protocol))
+        {
+            ESP_LOGW(kTag, "RX addProtocol: protocol %u is disabled at build time", static_cast<unsigned>(protocol));
+            return false;
+        }
+        dedupAppend(config_.protocols, protocol);
+        configResolved_ = false;
         return true;
     }
     bool Receiver::clearProtocols()
     {
         if (begun_)
             return false;
-        protocols_.clear();
+        config_.protocols.clear();
+        configResolved_ = false;
         return true;
     }
     bool Receiver::useRawOnly()
     {
         if (begun_)
             return false;
-        useRawOnly_ = true;
-        useRawPlusKnown_ = false;
+        config_.rawOnly = true;
+        config_.rawPlusKnown = false;
+        configResolved_ = false;
         return true;
     }
     bool Receiver::useRawPlusKnown()
     {
         if (begun_)
             return false;
-        useRawOnly_ = false;
-        useRawPlusKnown_ = true;
+        config_.rawOnly = false;
+        config_.rawPlusKnown = true;
+        configResolved_ = false;
         return true;
     }
     bool Receiver::useKnownWithoutAC()
     {
         if (begun_)
             return false;
-        useKnownNoAC_ = true;
+        config_.knownWithoutAC = true;
+        configResolved_ = false;
         return true;
     }
 
-    namespace
+    RxConfig Receiver::config() const
     {
-        void pushSeq(std::vector<int8_t> &seq, bool mark, uint32_t durationUs, uint16_t T_us)
+        return config_;
+    }
+
+    bool Receiver::reconfigure(const RxConfig &config)
+    {
+        for (auto p : config.protocols)
         {
-            if (T_us == 0 || durationUs == 0)
+            if (!esp32ir::protocolEnabled(p))
             {
-                return;
+                ESP_LOGW(kTag, "RX reconfigure: protocol %u is disabled at build time", static_cast<unsigned>(p));
+                return false;
             }
-            uint32_t counts = (durationUs + (T_us / 2)) / T_us;
-            if (counts == 0)
+        }
+        if (!begun_)
+        {
+            config_ = config;
+            configResolved_ = false;
+            return true;
+        }
+        // Zero-alloc known-only receivers keep frames as pulses only; RAW results need the ITPS pool.
+        if (zeroAlloc_ && pulseMode_ && (config.rawOnly || config.rawPlusKnown))
+        {
+            ESP_LOGW(kTag, "RX reconfigure rejected: zero-alloc receiver begun in a known-only mode cannot switch to RAW");
+            return false;
+        }
+        // Take the spare slot; a set that is still waiting for the consumer is replaced.
+        uint8_t state = kConfigIdle;
+        if (!configState_.compare_exchange_strong(state, kConfigWriting, std::memory_order_acquire) &&
+            !(state == kConfigReady && configState_.compare_exchange_strong(state, kConfigWriting, std::memory_order_acquire)))
+        {
+            ESP_LOGW(kTag, "RX reconfigure rejected: another reconfigure is in progress");
+            return false;
+        }
+        ActiveConfig &next = configs_[1 - activeConfig_.load(std::memory_order_relaxed)];
+        resolveConfig(config, next);
+        if (std::max(next.params.frameGapUs, next.params.hardGapUs) * 1000ULL > rxConfig_.signal_range_max_ns)
+        {
+            ESP_LOGW(kTag, "RX reconfigure: captures still end after the %u us idle threshold set at begin",
+                     static_cast<unsigned>(rxConfig_.signal_range_max_ns / 1000));
+        }
+        config_ = config;
+        configState_.store(kConfigReady, std::memory_order_release);
+        return true;
+    }
+
+    namespace
+    {
+        // Adapts two callables to the FrameSplitter sink interface.
+        template <typename Put, typename Commit>
+        struct CallbackSink
+        {
+            Put put;
+            Commit commit;
+        };
+
+        template <typename Put, typename Commit>
+        CallbackSink<Put, Commit> makeSink(Put put, Commit commit)
+        {
+            return {put, commit};
+        }
+
+        // Make room for `needed` items; a fixed (zero-alloc) pool never grows.
+        template <typename T>
+        bool growPool(std::vector<T> &pool, size_t needed, bool fixed)
+        {
+            if (needed <= pool.size())
             {
-                counts = 1;
+                return true;
             }
-            while (counts > 127)
+            if (fixed)
             {
-                seq.push_back(mark ? 127 : -127);
-                counts -= 127;
+                return false;
             }
-            seq.push_back(static_cast<int8_t>(mark ? counts : -static_cast<int>(counts)));
+            pool.resize(std::max(pool.size() * 2, needed));
+            return true;
         }
 
-        void normalizeSeq(std::vector<int8_t> &seq)
+        // Feed every RMT symbol of an event through a FrameSplitter resumed from state; returns true if frames
+        // were lost. The last event of a capture (last) flushes the final frame, earlier ones leave it in state.
+        template <typename Sink>
+        bool splitSymbols(const rmt_rx_done_event_data_t &ev, const esp32ir::RxParamPreset &params, uint16_t T_us, Sink &sink,
+                          esp32ir::FrameSplitState &state, bool last, uint32_t glitchCounts)
         {
-            std::vector<int8_t> out;
-            out.reserve(seq.size());
-            for (int v : seq)
+            esp32ir::FrameSplitter<Sink> splitter(params, T_us, sink, state, glitchCounts);
+            for (size_t i = 0; i < ev.num_symbols; ++i)
             {
-                if (v == 0)
-                {
-                    continue;
-                }
-                if (out.empty() || (out.back() > 0) != (v > 0))
-                {
-                    out.push_back(static_cast<int8_t>(v));
-                    continue;
-                }
-                int last = out.back();
-                out.pop_back();
-                int total = last + v;
-                int sign = (total >= 0) ? 1 : -1;
-                int remaining = total * sign;
-                while (remaining > 127)
-                {
-                    out.push_back(static_cast<int8_t>(sign * 127));
-                    remaining -= 127;
-                }
-                if (remaining > 0)
-                {
-                    out.push_back(static_cast<int8_t>(sign * remaining));
-                }
+                // invertInput_ is already applied by RMT hardware (flags.invert_in).
+                // Durations are RMT ticks at 1/T resolution, i.e. already quantized ITPS counts.
+                const auto &sym = ev.received_symbols[i];
+                splitter.push(sym.level0 != 0, sym.duration0);
+                splitter.push(sym.level1 != 0, sym.duration1);
+            }
+            if (last)
+            {
+                splitter.finish();
             }
-            seq.swap(out);
+            state = splitter.state();
+            return splitter.overflowed();
         }
 
-        bool appendFrameIfValid(const std::vector<int8_t> &seq, uint16_t T_us, const RxParams &params, std::vector<std::vector<int8_t>> &outFrames, bool allowShort = false)
+        // Log2 bucket of a latency (RxLatencyHistogram).
+        size_t latencyBucket(int64_t us)
         {
-            if (seq.empty())
+            if (us < 2)
             {
-                return true;
+                return 0;
             }
-            uint32_t totalUs = 0;
-            for (int v : seq)
+            size_t bucket = 63 - static_cast<size_t>(__builtin_clzll(static_cast<uint64_t>(us)));
+            return std::min(bucket, esp32ir::RxLatencyHistogram::kBuckets - 1);
+        }
+
+        // Adds the CPU cycles of its scope to a RxStats::decodeCycles counter (none: not counted).
+        class CycleMeter
+        {
+        public:
+            explicit CycleMeter(std::atomic<uint32_t> *counter) : counter_(counter), start_(counter ? esp_cpu_get_cycle_count() : 0) {}
+            ~CycleMeter()
             {
-                int mag = v < 0 ? -v : v;
-                totalUs += static_cast<uint32_t>(mag) * static_cast<uint32_t>(T_us);
+                if (counter_)
+                {
+                    counter_->fetch_add(static_cast<uint32_t>(esp_cpu_get_cycle_count() - start_), std::memory_order_relaxed);
+                }
             }
-            if (!allowShort && (seq.size() < params.minEdges || totalUs < params.minFrameUs))
+
+        private:
+            std::atomic<uint32_t> *counter_;
+            uint32_t start_;
+        };
+
+        void setRawStatus(esp32ir::RxResult &out, esp32ir::RxStatus status)
+        {
+            out.status = status;
+            out.protocol = esp32ir::Protocol::RAW;
+            out.message = {esp32ir::Protocol::RAW, nullptr, 0, 0};
+            out.payloadStorage.clear();
+        }
+
+        // Keep a RAW result's frames. One that does not fit a fixed RxResult (StaticRxResult) keeps its head and
+        // is reported as OVERFLOW.
+        void setRawFrames(esp32ir::RxResult &out, const esp32ir::ITPSView &buf)
+        {
+            out.raw.assign(buf);
+            if (out.raw.overflowed())
             {
-                return true; // treat as noise; not an error
+                out.status = esp32ir::RxStatus::OVERFLOW;
             }
-            outFrames.push_back(seq);
-            if (params.frameCountMax == 0)
+        }
+
+        // Index of the first space pulse of at least gapUs that is followed by more pulses.
+        bool findPulseGap(const esp32ir::PulseView &pulses, uint32_t gapUs, size_t &gapIndex)
+        {
+            for (size_t i = 1; i + 1 < pulses.size(); ++i)
             {
-                return true;
+                if (!pulses[i].mark && pulses[i].us >= gapUs)
+                {
+                    gapIndex = i;
+                    return true;
+                }
             }
-            return outFrames.size() <= params.frameCountMax;
+            return false;
         }
 
-        bool splitITPSByGap(const esp32ir::ITPSBuffer &buf, uint32_t gapUs, esp32ir::ITPSBuffer &firstOut, esp32ir::ITPSBuffer &secondOut)
+        // Locate the first space run of at least gapUs inside frame 0; [0, gapStart) is the first part, [restStart, len) the remainder.
+        bool findGapSplit(const esp32ir::ITPSView &buf, uint32_t gapUs, size_t &gapStart, size_t &restStart)
         {
             if (buf.frameCount() == 0 || gapUs == 0)
             {
@@ -690,8 +1284,8 @@ namespace esp32ir
             }
             uint32_t runUs = 0;
             size_t runStart = 0;
-            size_t gapStart = 0;
             size_t gapLen = 0;
+            gapStart = 0;
             for (uint16_t i = 0; i < f.len; ++i)
             {
                 int v = f.seq[i];
@@ -722,263 +1316,792 @@ namespace esp32ir
             {
                 return false;
             }
-            std::vector<int8_t> seq1;
-            seq1.reserve(f.len);
-            for (size_t i = 0; i < gapStart; ++i)
+            restStart = gapStart + gapLen;
+            return true;
+        }
+    } // namespace
+
+    void Receiver::setupArena()
+    {
+        arena_->poolUsed = 0;
+        arena_->streaming = false;
+        arena_->spanHead = 0;
+        arena_->spanCount = 0;
+        growArena();
+        heapAllocCount_ = 0;
+        droppedResults_ = 0;
+    }
+
+    void Receiver::growArena()
+    {
+        // Each RMT symbol yields two entries; long marks/spaces add 127-count chunks, so allow 4 entries per symbol.
+        const size_t symbols = arenaSymbols_ ? arenaSymbols_ : rxBufferSymbols_;
+        const size_t entries = symbols * 4;
+        auto grow = [](auto &v, size_t n, auto fill)
+        {
+            if (v.size() < n)
             {
-                seq1.push_back(f.seq[i]);
+                v.assign(n, fill);
             }
-            std::vector<int8_t> seq2;
-            seq2.reserve(f.len - gapStart - gapLen);
-            for (size_t i = gapStart + gapLen; i < f.len; ++i)
+        };
+        if (pulseMode_)
+        {
+            // A symbol adds at most one mark and one space pulse.
+            grow(arena_->pulses, symbols * 2, esp32ir::Pulse{false, 0});
+        }
+        else
+        {
+            grow(arena_->pool, entries, int8_t{0});
+            grow(arena_->pulseScratch, symbols * 2, esp32ir::Pulse{false, 0});
+        }
+        // frameCountMax frames, one flagged overflow frame, and one split remainder. Only an empty ring is
+        // regrown here (begin, or a config switch between captures).
+        if (arena_->spanCount == 0)
+        {
+            grow(arena_->spans, static_cast<size_t>(live().params.frameCountMax) + 2, FrameSpan{0, 0, false, 0, 0});
+        }
+    }
+
+    size_t Receiver::heapBytes(const esp32ir::RxResult &out) const
+    {
+        return arena_->pool.capacity() + (arena_->pulses.capacity() + arena_->pulseScratch.capacity()) * sizeof(esp32ir::Pulse) +
+               arena_->spans.capacity() * sizeof(FrameSpan) +
+               decodeRest_.reservedBytes() + out.raw.reservedBytes() + out.payloadStorage.capacity();
+    }
+
+    bool Receiver::reservePool(size_t len)
+    {
+        if (pulseMode_)
+        {
+            return growPool(arena_->pulses, arena_->poolUsed + len, zeroAlloc_);
+        }
+        return growPool(arena_->pool, arena_->poolUsed + len, zeroAlloc_);
+    }
+
+    bool Receiver::pushSpan(const FrameSpan &span, bool front)
+    {
+        auto &spans = arena_->spans;
+        if (arena_->spanCount == spans.size())
+        {
+            if (zeroAlloc_)
             {
-                seq2.push_back(f.seq[i]);
+                return false;
             }
-            if (seq1.empty() || seq2.empty())
+            std::vector<FrameSpan> grown;
+            grown.reserve(std::max<size_t>(spans.size() * 2, 4));
+            for (size_t i = 0; i < arena_->spanCount; ++i)
             {
-                return false;
+                grown.push_back(spans[(arena_->spanHead + i) % spans.size()]);
             }
-            firstOut.clear();
-            secondOut.clear();
-            esp32ir::ITPSFrame f1{f.T_us, static_cast<uint16_t>(seq1.size()), seq1.data(), 0};
-            esp32ir::ITPSFrame f2{f.T_us, static_cast<uint16_t>(seq2.size()), seq2.data(), 0};
-            firstOut.addFrame(f1);
-            secondOut.addFrame(f2);
-            return true;
+            grown.resize(grown.capacity(), FrameSpan{0, 0, false, 0, 0});
+            spans.swap(grown);
+            arena_->spanHead = 0;
         }
-    } // namespace
+        if (front)
+        {
+            arena_->spanHead = (arena_->spanHead + spans.size() - 1) % spans.size();
+            spans[arena_->spanHead] = span;
+        }
+        else
+        {
+            spans[(arena_->spanHead + arena_->spanCount) % spans.size()] = span;
+        }
+        ++arena_->spanCount;
+        return true;
+    }
 
-    bool Receiver::decode(const esp32ir::ITPSBuffer &buf, esp32ir::RxResult &out, bool overflowed)
+    bool Receiver::decode(const esp32ir::ITPSView &buf, esp32ir::RxResult &out, bool overflowed)
     {
-        auto fillRaw = [&](esp32ir::RxStatus status) -> bool
+        if (decodeLock_)
         {
-            out.status = status;
-            out.protocol = esp32ir::Protocol::RAW;
-            out.message = {esp32ir::Protocol::RAW, nullptr, 0, 0};
-            out.raw = buf;
-            out.payloadStorage.clear();
-            return true;
-        };
+            xSemaphoreTake(decodeLock_, portMAX_DELAY);
+        }
+        if (!begun_ && !configResolved_)
+        {
+            resolveConfig(config_, configs_[activeConfig_.load(std::memory_order_relaxed)]); // decode() before begin()
+            configResolved_ = true;
+        }
+        const size_t before = heapBytes(out);
+        out.timing = {};
+        out.source = 0;
+        decodeRest_.clear();
+        decodeRestPos_ = 0;
+        bool ok = decodeFrame(buf, nullptr, out, overflowed);
+        out.timing.decodedUs = esp_timer_get_time();
+        if (begun_ && heapBytes(out) > before)
+        {
+            ++heapAllocCount_;
+        }
+        if (decodeLock_)
+        {
+            xSemaphoreGive(decodeLock_);
+        }
+        return ok;
+    }
 
-        if (overflowed)
+    bool Receiver::decodeNext(esp32ir::RxResult &out)
+    {
+        if (decodeLock_)
         {
-            return fillRaw(esp32ir::RxStatus::OVERFLOW);
+            xSemaphoreTake(decodeLock_, portMAX_DELAY);
         }
-        if (useRawOnly_)
+        bool ok = false;
+        if (decodeRest_.frameCount() > 0 && decodeRestPos_ < decodeRest_.frame(0).len)
         {
-            return fillRaw(esp32ir::RxStatus::RAW_ONLY);
+            const auto &f = decodeRest_.frame(0);
+            const esp32ir::ITPSFrame rest{f.T_us, static_cast<uint16_t>(f.len - decodeRestPos_), f.seq + decodeRestPos_, f.flags};
+            decodeRestPos_ = f.len; // consumed unless this frame splits again
+            const size_t before = heapBytes(out);
+            out.timing = {};
+            out.source = 0;
+            ok = decodeFrame(esp32ir::ITPSView(&rest, 1), nullptr, out, false);
+            out.timing.decodedUs = esp_timer_get_time();
+            if (begun_ && heapBytes(out) > before)
+            {
+                ++heapAllocCount_;
+            }
         }
+        if (decodeLock_)
+        {
+            xSemaphoreGive(decodeLock_);
+        }
+        return ok;
+    }
+
+    bool Receiver::decodeFrame(const esp32ir::ITPSView &buf, const FrameSpan *origin, esp32ir::RxResult &out, bool overflowed)
+    {
+        if (overflowed || live().rawOnly)
+        {
+            setRawStatus(out, overflowed ? esp32ir::RxStatus::OVERFLOW : esp32ir::RxStatus::RAW_ONLY);
+            setRawFrames(out, buf);
+            return true;
+        }
+        // Merge the frame into pulses once; every decoder works on the same view.
+        // A fixed (zero-alloc) scratch only truncates very long frames, whose tail no decoder looks at.
+        auto &scratch = arena_->pulseScratch;
+        growPool(scratch, buf.frame(0).len, zeroAlloc_ && begun_);
+        return decodePulses(esp32ir::makePulseView(buf, scratch.data(), scratch.size()), &buf, origin, out);
+    }
+
+    bool Receiver::decodePulses(const esp32ir::PulseView &pulses, const esp32ir::ITPSView *buf, const FrameSpan *origin, esp32ir::RxResult &out)
+    {
+        const ActiveConfig &cfg = live();
+        // A decoded frame ends at the first space longer than any mark/space of its protocol (frameEndIdleUs).
+        // Whatever follows (repeat codes, the next press) is queued as a frame of its own; for received frames
+        // that is a span over the same pool storage, so nothing is copied.
+        size_t firstLen = 0;
+        auto splitRest = [&](esp32ir::Protocol proto)
+        {
+            const uint32_t endUs = frameEndIdleUs(proto);
+            if (endUs == 0)
+            {
+                return; // AC messages keep their inner gaps
+            }
+            const uint32_t protoGap = endUs + 1;
+            if (!buf)
+            {
+                // Pulse-mode span: the remainder already lives in the pulse pool.
+                size_t gapIndex = 0;
+                if (!findPulseGap(pulses, protoGap, gapIndex))
+                {
+                    return;
+                }
+                size_t restLen = pulses.size() - gapIndex - 1;
+                uint32_t headUs = 0;
+                for (size_t i = 0; i < gapIndex; ++i)
+                {
+                    headUs += pulses[i].us;
+                }
+                if (!pushSpan({static_cast<uint32_t>(origin->offset + gapIndex + 1), static_cast<uint16_t>(restLen), false,
+                               origin->startUs + headUs + pulses[gapIndex].us, origin->endUs},
+                              true))
+                {
+                    ESP_LOGW(kTag, "RX arena full; dropped %zu trailing pulses", restLen);
+                }
+                out.timing.lastEdgeUs = out.timing.firstEdgeUs + headUs;
+                return;
+            }
+            size_t gapStart = 0;
+            size_t restStart = 0;
+            if (!findGapSplit(*buf, protoGap, gapStart, restStart))
+            {
+                return;
+            }
+            const auto &f = buf->frame(0);
+            size_t restLen = f.len - restStart;
+            if (origin)
+            {
+                // Remainder already lives in the pool.
+                FrameSpan span{static_cast<uint32_t>(origin->offset + restStart), static_cast<uint16_t>(restLen), false, 0, 0};
+                uint32_t headUs = 0;
+                uint32_t restUs = 0;
+                for (size_t i = 0; i < restStart; ++i)
+                {
+                    uint32_t us = static_cast<uint32_t>(f.seq[i] < 0 ? -f.seq[i] : f.seq[i]) * f.T_us;
+                    (i < gapStart ? headUs : restUs) += us;
+                }
+                span.startUs = origin->startUs + headUs + restUs;
+                span.endUs = origin->endUs;
+                out.timing.lastEdgeUs = out.timing.firstEdgeUs + headUs;
+                // Decoded next, ahead of later captures, so poll() keeps capture order.
+                if (!pushSpan(span, true))
+                {
+                    ESP_LOGW(kTag, "RX arena full; dropped %zu trailing entries", restLen);
+                    return;
+                }
+            }
+            else
+            {
+                // decode(): the caller's buffer does not outlive the call, so the remainder is kept in
+                // decodeRest_ for decodeNext(). The RX pool may hold a capture that is still arriving.
+                const int8_t *restBase = decodeRest_.frameCount() ? decodeRest_.frame(0).seq : nullptr;
+                if (restBase && f.seq >= restBase && f.seq < restBase + decodeRest_.frame(0).len)
+                {
+                    decodeRestPos_ = static_cast<size_t>(f.seq - restBase) + restStart; // already stored
+                }
+                else
+                {
+                    decodeRest_.clear();
+                    decodeRest_.addFrame({f.T_us, static_cast<uint16_t>(restLen), f.seq + restStart, f.flags});
+                    decodeRestPos_ = 0;
+                }
+            }
+            firstLen = gapStart;
+        };
 
-        auto fillDecoded = [&](esp32ir::Protocol proto, const void *payload, size_t len, const esp32ir::ITPSBuffer *rawPtr = nullptr) -> bool
+        auto fillDecoded = [&](esp32ir::Protocol proto, const void *payload, size_t len) -> bool
         {
+            splitRest(proto);
             out.payloadStorage.assign(reinterpret_cast<const uint8_t *>(payload),
                                       reinterpret_cast<const uint8_t *>(payload) + len);
             out.message = {proto, out.payloadStorage.data(), static_cast<uint16_t>(len), 0};
             out.protocol = proto;
             out.status = esp32ir::RxStatus::DECODED;
-            if (useRawPlusKnown_)
+            if (!cfg.rawPlusKnown || !buf)
             {
-                out.raw = rawPtr ? *rawPtr : buf;
+                out.raw.clear();
             }
-            else
+            else if (firstLen > 0)
             {
+                const auto &f = buf->frame(0);
                 out.raw.clear();
+                out.raw.addFrame({f.T_us, static_cast<uint16_t>(firstLen), f.seq, 0});
+            }
+            else
+            {
+                out.raw.assign(*buf);
             }
             return true;
         };
+        (void)splitRest; // unused when no codec is compiled in
+        (void)fillDecoded;
 
-        auto protocolsToTry = protocols_.empty() ? (useKnownNoAC_ ? knownWithoutAC() : allKnownProtocols()) : protocols_;
-
-        esp32ir::RxResult temp;
-        temp.status = esp32ir::RxStatus::RAW_ONLY;
-        temp.protocol = esp32ir::Protocol::RAW;
-        temp.message = {esp32ir::Protocol::RAW, nullptr, 0, 0};
-        temp.raw = buf;
-
-        for (auto proto : protocolsToTry)
+        // Only the decoders whose header window contains the first mark/space run, in protocol order.
+        uint32_t candidates = 0;
+        if (pulses.size() >= 2 && pulses[0].mark && !pulses[1].mark)
+        {
+            const uint32_t markUs = pulses[0].us;
+            const uint32_t spaceUs = pulses[1].us;
+            for (const auto &route : cfg.routes)
+            {
+                bool hit = route.balanced ? esp32ir::inRange(spaceUs, markUs, 40)
+                                          : (markUs >= route.markLo && markUs <= route.markHi && spaceUs >= route.spaceLo && spaceUs <= route.spaceHi);
+                if (hit)
+                {
+                    candidates |= route.mask;
+                }
+            }
+        }
+        // NEC-like members share one pulse-distance pass per timing family.
+        nec_like::BitsCache family(pulses);
+        while (candidates)
         {
+            const esp32ir::Protocol proto = cfg.routeProtocols[__builtin_ctz(candidates)];
+            candidates &= candidates - 1;
+            // Only received frames count (origin is null for decode()); a successful decoder returns from here.
+            CycleMeter meter(origin ? &stats_.decodeCycles[static_cast<size_t>(proto)] : nullptr);
             switch (proto)
             {
+#if ESP32IR_ENABLE_NEC
             case esp32ir::Protocol::NEC:
             {
                 esp32ir::payload::NEC p{};
-                if (esp32ir::decodeNEC(temp, p))
+                if (nec_like::decodeNEC(pulses, family.get(nec_like::Family::NEC), p))
                 {
-                    esp32ir::ITPSBuffer firstBuf;
-                    esp32ir::ITPSBuffer secondBuf;
-                    const esp32ir::ITPSBuffer *rawPtr = &buf;
-                    uint32_t protoGap = recommendedParamsForProtocol(proto).frameGapUs;
-                    if (protoGap > 0 && splitITPSByGap(buf, protoGap, firstBuf, secondBuf))
-                    {
-                        rawPtr = &firstBuf;
-                        pendingSegments_.push_back({std::move(secondBuf), overflowed});
-                    }
-                    return fillDecoded(proto, &p, sizeof(p), rawPtr);
+                    return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_SONY
             case esp32ir::Protocol::SONY:
             {
                 esp32ir::payload::SONY p{};
-                if (esp32ir::decodeSONY(temp, p))
+                if (esp32ir::decodeSONY(pulses, p))
                 {
-                    esp32ir::ITPSBuffer firstBuf;
-                    esp32ir::ITPSBuffer secondBuf;
-                    const esp32ir::ITPSBuffer *rawPtr = &buf;
-                    uint32_t protoGap = recommendedParamsForProtocol(proto).frameGapUs;
-                    if (protoGap > 0 && splitITPSByGap(buf, protoGap, firstBuf, secondBuf))
-                    {
-                        rawPtr = &firstBuf;
-                        pendingSegments_.push_back({std::move(secondBuf), overflowed});
-                    }
-                    return fillDecoded(proto, &p, sizeof(p), rawPtr);
+                    return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_AEHA
             case esp32ir::Protocol::AEHA:
             {
                 esp32ir::payload::AEHA p{};
-                if (esp32ir::decodeAEHA(temp, p))
+                if (esp32ir::decodeAEHA(pulses, p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_PANASONIC
             case esp32ir::Protocol::Panasonic:
             {
                 esp32ir::payload::Panasonic p{};
-                if (esp32ir::decodePanasonic(temp, p))
+                if (nec_like::decodePanasonic(family.get(nec_like::Family::Panasonic), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_JVC
             case esp32ir::Protocol::JVC:
             {
                 esp32ir::payload::JVC p{};
-                if (esp32ir::decodeJVC(temp, p))
+                if (nec_like::decodeJVC(family.get(nec_like::Family::JVC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG
             case esp32ir::Protocol::Samsung:
             {
                 esp32ir::payload::Samsung p{};
-                if (esp32ir::decodeSamsung(temp, p))
+                if (nec_like::decodeSamsung(family.get(nec_like::Family::Samsung), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG36
             case esp32ir::Protocol::Samsung36:
             {
                 esp32ir::payload::Samsung36 p{};
-                if (esp32ir::decodeSamsung36(temp, p))
+                if (nec_like::decodeSamsung36(family.get(nec_like::Family::Samsung), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_LG
             case esp32ir::Protocol::LG:
             {
                 esp32ir::payload::LG p{};
-                if (esp32ir::decodeLG(temp, p))
+                if (nec_like::decodeLG(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_DENON
             case esp32ir::Protocol::Denon:
             {
                 esp32ir::payload::Denon p{};
-                if (esp32ir::decodeDenon(temp, p))
+                if (nec_like::decodeDenon(pulses, family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_RC5
             case esp32ir::Protocol::RC5:
             {
                 esp32ir::payload::RC5 p{};
-                if (esp32ir::decodeRC5(temp, p))
+                if (esp32ir::decodeRC5(pulses, p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_RC6
             case esp32ir::Protocol::RC6:
             {
                 esp32ir::payload::RC6 p{};
-                if (esp32ir::decodeRC6(temp, p))
+                if (esp32ir::decodeRC6(pulses, p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_APPLE
             case esp32ir::Protocol::Apple:
             {
                 esp32ir::payload::Apple p{};
-                if (esp32ir::decodeApple(temp, p))
+                if (nec_like::decodeApple(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_PIONEER
             case esp32ir::Protocol::Pioneer:
             {
                 esp32ir::payload::Pioneer p{};
-                if (esp32ir::decodePioneer(temp, p))
+                if (nec_like::decodePioneer(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_TOSHIBA
             case esp32ir::Protocol::Toshiba:
             {
                 esp32ir::payload::Toshiba p{};
-                if (esp32ir::decodeToshiba(temp, p))
+                if (nec_like::decodeToshiba(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_MITSUBISHI
             case esp32ir::Protocol::Mitsubishi:
             {
                 esp32ir::payload::Mitsubishi p{};
-                if (esp32ir::decodeMitsubishi(temp, p))
+                if (nec_like::decodeMitsubishi(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
+#if ESP32IR_ENABLE_HITACHI
             case esp32ir::Protocol::Hitachi:
             {
                 esp32ir::payload::Hitachi p{};
-                if (esp32ir::decodeHitachi(temp, p))
+                if (nec_like::decodeHitachi(family.get(nec_like::Family::NEC), p))
                 {
                     return fillDecoded(proto, &p, sizeof(p));
                 }
                 break;
             }
+#endif
             default:
                 break;
             }
         }
-        if (useRawPlusKnown_)
+        if (origin)
+        {
+            stats_.decodeMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (cfg.rawPlusKnown && buf)
         {
-            return fillRaw(esp32ir::RxStatus::RAW_ONLY);
+            setRawStatus(out, esp32ir::RxStatus::RAW_ONLY);
+            setRawFrames(out, *buf);
+            return true;
         }
         return false;
     }
 
+    void Receiver::resolveConfig(const RxConfig &config, ActiveConfig &out) const
+    {
+        static_cast<RxConfig &>(out) = config; // reuses the slot's storage
+        if (!out.rawOnly)
+        {
+            if (out.protocols.empty())
+            {
+                const auto &all = out.knownWithoutAC ? knownWithoutAC() : allKnownProtocols();
+                out.protocols.assign(all.begin(), all.end());
+            }
+            else
+            {
+                // Explicit list: drop duplicates, and AC protocols under knownWithoutAC.
+                size_t n = 0;
+                for (size_t i = 0; i < out.protocols.size(); ++i)
+                {
+                    const esp32ir::Protocol p = out.protocols[i];
+                    if ((out.knownWithoutAC && isACProtocol(p)) || std::find(out.protocols.begin(), out.protocols.begin() + n, p) != out.protocols.begin() + n)
+                    {
+                        continue;
+                    }
+                    out.protocols[n++] = p;
+                }
+                out.protocols.resize(n);
+            }
+        }
+        RxParams params = defaultParams(out.rawOnly || out.rawPlusKnown);
+        if (!out.rawOnly)
+        {
+            for (auto proto : out.protocols)
+            {
+                mergeParams(params, recommendedParamsForProtocol(proto));
+            }
+        }
+        if (config.frameGapUs > 0)
+            params.frameGapUs = config.frameGapUs;
+        if (config.hardGapUs > 0)
+            params.hardGapUs = config.hardGapUs;
+        if (config.minFrameUs > 0)
+            params.minFrameUs = config.minFrameUs;
+        if (config.maxFrameUs > 0)
+            params.maxFrameUs = config.maxFrameUs;
+        if (config.minEdges > 0)
+            params.minEdges = config.minEdges;
+        if (config.frameCountMax > 0)
+            params.frameCountMax = config.frameCountMax;
+        if (config.splitPolicySet)
+            params.splitPolicy = config.splitPolicy;
+        out.params = {params.frameGapUs, params.hardGapUs, params.minFrameUs, params.maxFrameUs, params.minEdges, params.frameCountMax, params.splitPolicy};
+
+        out.routes.clear();
+        out.routeProtocols.clear();
+        for (auto proto : out.protocols)
+        {
+            HeaderWindow w{};
+            if (out.routeProtocols.size() >= 32 || !headerWindow(proto, w))
+            {
+                continue;
+            }
+            HeaderRoute route{w.markLo, w.markHi, w.spaceLo, w.spaceHi, w.balanced, 0};
+            const uint32_t bit = 1u << out.routeProtocols.size();
+            out.routeProtocols.push_back(proto);
+            // Protocols sharing a header window share one route, so per-frame work does not grow with the list.
+            auto it = std::find_if(out.routes.begin(), out.routes.end(), [&](const HeaderRoute &r)
+                                   { return r.markLo == route.markLo && r.markHi == route.markHi && r.spaceLo == route.spaceLo &&
+                                            r.spaceHi == route.spaceHi && r.balanced == route.balanced; });
+            if (it != out.routes.end())
+            {
+                it->mask |= bit;
+            }
+            else
+            {
+                route.mask = bit;
+                out.routes.push_back(route);
+            }
+        }
+    }
+
     bool Receiver::poll(esp32ir::RxResult &out)
+    {
+        if (!decodeTask_)
+        {
+            wakeUs_ = 0; // nothing waited, so nothing to measure
+        }
+        return pollOnce(out);
+    }
+
+    bool Receiver::poll(esp32ir::RxResult &out, TickType_t timeoutTicks)
+    {
+        if (!decodeTask_)
+        {
+            wakeUs_ = 0;
+        }
+        const TickType_t start = xTaskGetTickCount();
+        for (;;)
+        {
+            if (pollOnce(out))
+            {
+                return true;
+            }
+            SemaphoreHandle_t wake = decodeTask_ ? resultReady_ : rxWake_;
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (!wake || (timeoutTicks != portMAX_DELAY && elapsed >= timeoutTicks))
+            {
+                return false;
+            }
+            // A give left over from an already consumed event only costs one more pass.
+            if (xSemaphoreTake(wake, timeoutTicks == portMAX_DELAY ? portMAX_DELAY : timeoutTicks - elapsed) == pdTRUE && !decodeTask_)
+            {
+                wakeUs_ = esp_timer_get_time();
+            }
+        }
+    }
+
+    void Receiver::applyPendingConfig()
+    {
+        // Between captures only: no pending frames and no capture continued by the next RMT event.
+        if (configState_.load(std::memory_order_relaxed) != kConfigReady || arena_->spanCount > 0 || arena_->streaming)
+        {
+            return;
+        }
+        uint8_t state = kConfigReady;
+        if (!configState_.compare_exchange_strong(state, kConfigApplying, std::memory_order_acquire))
+        {
+            return;
+        }
+        activeConfig_.store(1 - activeConfig_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        const ActiveConfig &cfg = live();
+        // Under zero-alloc the storage chosen at begin() stays; a known-only set then decodes from ITPS frames.
+        if (!zeroAlloc_)
+        {
+            const size_t before = heapBytes(droppedResult_);
+            pulseMode_ = !cfg.rawOnly && !cfg.rawPlusKnown;
+            growArena();
+            if (heapBytes(droppedResult_) > before)
+            {
+                ++heapAllocCount_;
+            }
+        }
+        // The other slot now holds the previous set; reconfigure() may overwrite it once this is released.
+        configState_.store(kConfigIdle, std::memory_order_release);
+        ESP_LOGD(kTag, "RX reconfigured: mode=%s protocols=%u frameGapUs=%u",
+                 cfg.rawOnly ? "RAW_ONLY" : (cfg.rawPlusKnown ? "RAW_PLUS_KNOWN" : (cfg.knownWithoutAC ? "KNOWN_NO_AC" : "KNOWN_ONLY")),
+                 static_cast<unsigned>(cfg.protocols.size()), static_cast<unsigned>(cfg.params.frameGapUs));
+    }
+
+    void Receiver::takeResult(esp32ir::RxResult &out, esp32ir::RxResult &slot)
+    {
+        // Only caller-side storage is counted: the decode task may be growing the arena meanwhile.
+        bool grew = false;
+        out.status = slot.status;
+        out.protocol = slot.protocol;
+        out.timing = slot.timing;
+        out.source = slot.source;
+        if (out.raw.fixed_ || slot.raw.fixed_)
+        {
+            const size_t before = out.raw.reservedBytes();
+            out.raw = slot.raw; // fixed storage (StaticRxResult) stays with its buffer
+            grew = out.raw.reservedBytes() > before;
+        }
+        else
+        {
+            std::swap(out.raw, slot.raw); // heap storage changes owner, nothing is allocated
+        }
+        // The payload is a few bytes: copy it so each side keeps its reserved capacity.
+        const size_t payloadBefore = out.payloadStorage.capacity();
+        out.payloadStorage.assign(slot.payloadStorage.begin(), slot.payloadStorage.end());
+        grew = grew || out.payloadStorage.capacity() > payloadBefore;
+        out.message = slot.message;
+        if (slot.message.data && slot.message.data == slot.payloadStorage.data())
+        {
+            out.message.data = out.payloadStorage.data();
+        }
+        if (grew)
+        {
+            ++heapAllocCount_;
+        }
+    }
+
+    bool Receiver::pollOnce(esp32ir::RxResult &out)
+    {
+        if (decodeTask_)
+        {
+            // The decode task did all the work; hand over the finished result.
+            esp32ir::RxResult *slot = results_.readSlot();
+            if (!slot)
+            {
+                return false;
+            }
+            takeResult(out, *slot);
+            results_.pop();
+            return true;
+        }
+        applyPendingConfig();
+        const size_t before = heapBytes(out);
+        bool ok = pollFrame(out);
+        if (heapBytes(out) > before)
+        {
+            ++heapAllocCount_;
+        }
+        if (ok)
+        {
+            deliver(out);
+        }
+        return ok;
+    }
+
+    void Receiver::deliver(const esp32ir::RxResult &out)
+    {
+        if (wakeUs_ != 0)
+        {
+            uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - wakeUs_);
+            latencyLastUs_.store(us, std::memory_order_relaxed);
+            if (us > latencyMaxUs_.load(std::memory_order_relaxed))
+            {
+                latencyMaxUs_.store(us, std::memory_order_relaxed);
+            }
+            latencySamples_.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (const auto &sub : subscribers_)
+        {
+            if (!sub.filtered || sub.protocol == out.protocol)
+            {
+                sub.handler(out, sub.user);
+            }
+        }
+    }
+
+    bool Receiver::decodePendingSpan(esp32ir::RxResult &out)
+    {
+        FrameSpan span = arena_->spans[arena_->spanHead];
+        arena_->spanHead = (arena_->spanHead + 1) % arena_->spans.size();
+        --arena_->spanCount;
+        const int64_t startUs = esp_timer_get_time();
+        out.timing = {arena_->originUs + span.startUs, arena_->originUs + span.endUs, arena_->eventUs, 0};
+        out.source = source_;
+        if (!decodeSpan(span, out))
+        {
+            return false;
+        }
+        out.timing.decodedUs = esp_timer_get_time();
+        if (out.status == esp32ir::RxStatus::OVERFLOW)
+        {
+            stats_.overflows.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            const size_t index = static_cast<size_t>(out.protocol);
+            stats_.decoded[index < RxStats::kProtocols ? index : 0].fetch_add(1, std::memory_order_relaxed);
+        }
+        histQueued_[latencyBucket(startUs - arena_->eventUs)].fetch_add(1, std::memory_order_relaxed);
+        histDecode_[latencyBucket(out.timing.decodedUs - startUs)].fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Receiver::decodeSpan(const FrameSpan &span, esp32ir::RxResult &out)
+    {
+        if (pulseMode_)
+        {
+            esp32ir::PulseView pulses{arena_->pulses.data() + span.offset, span.len};
+            if (span.overflowed)
+            {
+                // The only place pulse mode hands out raw data: rebuild the ITPS frame from the pulses.
+                setRawStatus(out, esp32ir::RxStatus::OVERFLOW);
+                out.raw.clear();
+                size_t entries = esp32ir::itpsEntryCount(pulses, quantizeT_);
+                int8_t *seq = entries > 0 ? out.raw.appendFrame(quantizeT_, static_cast<uint16_t>(entries)) : nullptr;
+                if (seq)
+                {
+                    esp32ir::pulsesToITPS(pulses, quantizeT_, seq);
+                }
+                return true;
+            }
+            return decodePulses(pulses, nullptr, &span, out);
+        }
+        // Decode straight from the pool; only a result that keeps RAW copies the entries (into out.raw).
+        const esp32ir::ITPSFrame frame{quantizeT_, span.len, arena_->pool.data() + span.offset, 0};
+        return decodeFrame(esp32ir::ITPSView{&frame, 1}, &span, out, span.overflowed);
+    }
+
+    bool Receiver::pollFrame(esp32ir::RxResult &out)
     {
         if (!begun_)
         {
             ESP_LOGW(kTag, "RX poll called before begin");
         }
-        if (!rxQueue_)
+        if (rxEvents_.capacity() == 0)
         {
             return false;
         }
@@ -986,29 +2109,31 @@ namespace esp32ir
         {
             return false;
         }
-        if (!pendingSegments_.empty())
+        if (arena_->spanCount > 0)
         {
-            auto pending = std::move(pendingSegments_.front());
-            pendingSegments_.pop_front();
-            return decode(pending.raw, out, pending.overflowed);
+            return decodePendingSpan(out);
         }
         rmt_rx_done_event_data_t ev = {};
-        if (xQueueReceive(rxQueue_, &ev, 0) != pdTRUE)
+        if (!takeEvent(ev))
         {
             return false;
         }
-        int bufferIndex = -1;
-        for (uint8_t i = 0; i < 2; ++i)
+        return processEvent(ev, out);
+    }
+
+    bool Receiver::processEvent(const rmt_rx_done_event_data_t &ev, esp32ir::RxResult &out)
+    {
+        int bufferIndex = bufferIndexOf(&rxCallbackCtx_, ev.received_symbols);
+        // Partial RX: more events of this capture follow; a full buffer is then a chunk, not a truncation.
+        const bool chunk = ESP32IR_RX_PARTIAL && !ev.flags.is_last;
+        bool truncated = !ESP32IR_RX_PARTIAL && ev.num_symbols >= rxBufferSymbols_;
+        bool overflowed = rxOverflowed_.exchange(false, std::memory_order_relaxed) || (ev.num_symbols == 0) || (ev.received_symbols == nullptr) || (!ev.flags.is_last && !chunk);
+        stats_.rmtEvents.fetch_add(1, std::memory_order_relaxed);
+        stats_.symbols.fetch_add(static_cast<uint32_t>(ev.num_symbols), std::memory_order_relaxed);
+        if (truncated)
         {
-            if (rxBuffers_[i].data() == ev.received_symbols)
-            {
-                bufferIndex = static_cast<int>(i);
-                break;
-            }
+            stats_.truncations.fetch_add(1, std::memory_order_relaxed);
         }
-        bool truncated = ev.num_symbols >= rxBufferSymbols_;
-        bool overflowed = rxOverflowed_ || (ev.num_symbols == 0) || (ev.received_symbols == nullptr) || (!ev.flags.is_last);
-        rxOverflowed_ = false;
         ESP_LOGV(kTag, "RX RMT symbols=%u last=%d invert=%s T_us=%u",
                  static_cast<unsigned>(ev.num_symbols),
                  static_cast<int>(ev.flags.is_last),
@@ -1034,60 +2159,151 @@ namespace esp32ir
             ESP_LOGV(kTag, "RX RMT dump: %s%s", buf, (pos + 30 < sizeof(buf)) ? "..." : "");
         }
 #endif
-        std::vector<int8_t> seq;
-        seq.reserve(ev.num_symbols * 2);
-        for (size_t i = 0; i < ev.num_symbols; ++i)
+        // A capture is split with one config: reconfigure() only takes over between captures.
+        const ActiveConfig &cfg = live();
+        const RxParamPreset &params = cfg.params;
+
+        // Frames are written straight into the pool; the frame being built starts at poolUsed.
+        // Earlier spans are always decoded before the next event, so only a continued frame has to be kept.
+        const bool newCapture = !arena_->streaming;
+        if (newCapture)
+        {
+            arena_->poolUsed = 0;
+            arena_->split = {};
+            arena_->framePulses = 0;
+        }
+        else if (arena_->poolUsed > 0)
         {
-            const auto &sym = ev.received_symbols[i];
-            if (sym.duration0)
+            if (pulseMode_)
             {
-                // invertInput_ is already applied by RMT hardware (flags.invert_in).
-                bool mark = sym.level0 != 0;
-                uint32_t durUs = static_cast<uint32_t>(sym.duration0) * static_cast<uint32_t>(quantizeT_);
-                pushSeq(seq, mark, durUs, quantizeT_);
+                std::memmove(arena_->pulses.data(), arena_->pulses.data() + arena_->poolUsed, arena_->framePulses * sizeof(esp32ir::Pulse));
             }
-            if (sym.duration1)
+            else
             {
-                bool mark = sym.level1 != 0;
-                uint32_t durUs = static_cast<uint32_t>(sym.duration1) * static_cast<uint32_t>(quantizeT_);
-                pushSeq(seq, mark, durUs, quantizeT_);
+                std::memmove(arena_->pool.data(), arena_->pool.data() + arena_->poolUsed, arena_->split.currentLen);
             }
+            arena_->poolUsed = 0;
+        }
+        const uint16_t framesBefore = arena_->split.framesFound;
+        const uint16_t rejectedBefore = arena_->split.framesRejected;
+        const uint32_t glitchesBefore = arena_->split.glitches;
+        const uint32_t glitchCounts = (cfg.glitchFilterUs + quantizeT_ - 1) / quantizeT_;
+        bool lost = false;
+        if (pulseMode_)
+        {
+            // Entries are merged back into whole pulses as they arrive. DROP_GAP only ever trims a frame where
+            // its trailing space run began, i.e. at the start of the last pulse.
+            size_t &framePulses = arena_->framePulses;
+            size_t &lastPulseIndex = arena_->lastPulseIndex;
+            auto sink = makeSink(
+                [this, &framePulses, &lastPulseIndex](size_t index, int8_t v)
+                {
+                    if (index == 0)
+                    {
+                        framePulses = 0;
+                    }
+                    const bool mark = v > 0;
+                    const uint32_t us = static_cast<uint32_t>(mark ? v : -v) * quantizeT_;
+                    if (framePulses > 0)
+                    {
+                        esp32ir::Pulse &last = arena_->pulses[arena_->poolUsed + framePulses - 1];
+                        if (last.mark == mark)
+                        {
+                            last.us += us;
+                            return true;
+                        }
+                    }
+                    if (!reservePool(framePulses + 1))
+                    {
+                        return false;
+                    }
+                    arena_->pulses[arena_->poolUsed + framePulses] = {mark, us};
+                    ++framePulses;
+                    lastPulseIndex = index;
+                    return true;
+                },
+                [this, &framePulses, &lastPulseIndex](size_t len, uint32_t startUs, uint32_t endUs)
+                {
+                    size_t n = (framePulses > 0 && lastPulseIndex >= len) ? framePulses - 1 : framePulses;
+                    if (!pushSpan({static_cast<uint32_t>(arena_->poolUsed), static_cast<uint16_t>(n), false, startUs, endUs}))
+                    {
+                        return false;
+                    }
+                    arena_->poolUsed += n;
+                    framePulses = 0;
+                    return true;
+                });
+            lost = splitSymbols(ev, params, quantizeT_, sink, arena_->split, !chunk, glitchCounts);
         }
+        else
+        {
+            auto sink = makeSink(
+                [this](size_t index, int8_t v)
+                {
+                    if (!reservePool(index + 1))
+                    {
+                        return false;
+                    }
+                    arena_->pool[arena_->poolUsed + index] = v;
+                    return true;
+                },
+                [this](size_t len, uint32_t startUs, uint32_t endUs)
+                {
+                    if (!pushSpan({static_cast<uint32_t>(arena_->poolUsed), static_cast<uint16_t>(len), false, startUs, endUs}))
+                    {
+                        return false;
+                    }
+                    arena_->poolUsed += len;
+                    return true;
+                });
+            lost = splitSymbols(ev, params, quantizeT_, sink, arena_->split, !chunk, glitchCounts);
+        }
+        // The splitter state carries its counts across the chunks of a capture; count only this event's share.
+        stats_.framesSplit.fetch_add(arena_->split.framesFound - framesBefore, std::memory_order_relaxed);
+        stats_.framesNoise.fetch_add(arena_->split.framesRejected - rejectedBefore, std::memory_order_relaxed);
+        stats_.glitches.fetch_add(arena_->split.glitches - glitchesBefore, std::memory_order_relaxed);
+        arena_->streaming = chunk;
+        // The ISR runs when a chunk fills up, or once the RMT idle threshold has passed after the last edge;
+        // the capture's first mark lies inputUs (plus a pulse the glitch filter still holds back) before that.
+        arena_->eventUs = bufferIndex >= 0 ? rxEventUs_[bufferIndex] : esp_timer_get_time();
+        if (newCapture)
+        {
+            const int64_t idleUs = chunk ? 0 : static_cast<int64_t>(rxConfig_.signal_range_max_ns / 1000);
+            arena_->originUs = arena_->eventUs - idleUs - arena_->split.inputUs - static_cast<int64_t>(arena_->split.heldCounts) * quantizeT_;
+        }
+        if (lost)
+        {
+            overflowed = true;
+        }
+
         // restart reception
         // rmt_receive is re-armed in ISR; if pending buffers exhausted and restart flagged, try here.
-        if (rxNeedRestart_)
+        if (rxNeedRestart_.load(std::memory_order_acquire))
         {
-            int freeIdx = -1;
-            uint8_t mask = rxPendingMask_;
-            for (uint8_t i = 0; i < 2; ++i)
-            {
-                if ((mask & (1u << i)) == 0)
-                {
-                    freeIdx = static_cast<int>(i);
-                    break;
-                }
-            }
+            int freeIdx = freeBufferIndex(&rxCallbackCtx_);
             if (freeIdx >= 0)
             {
-                esp_err_t rxErr = rmt_receive(rxChannel_, rxBuffers_[freeIdx].data(), rxBufferSymbols_ * sizeof(rmt_symbol_word_t), &rxConfig_);
-                if (rxErr == ESP_OK)
+                // Update the state first: once armed, the ISR may complete a capture and change it before we return.
+                rxArmedIndex_ = freeIdx;
+                rxNeedRestart_ = false;
+                esp_err_t rxErr = rmt_receive(rxChannel_, rxBuffer(static_cast<size_t>(freeIdx)), rxBufferSymbols_ * sizeof(rmt_symbol_word_t), &rxConfig_);
+                if (rxErr != ESP_OK)
                 {
-                    rxNeedRestart_ = false;
+                    rxArmedIndex_ = -1;
+                    rxNeedRestart_ = true;
+                    ESP_LOGW(kTag, "RX rmt_receive restart failed err=%d", static_cast<int>(rxErr));
+                    overflowed = true;
                 }
                 else
                 {
-                    ESP_LOGW(kTag, "RX rmt_receive restart failed err=%d", static_cast<int>(rxErr));
-                    overflowed = true;
+                    stats_.restarts.fetch_add(1, std::memory_order_relaxed);
                 }
             }
         }
+        // Symbols are consumed; hand the RMT buffer back to the ISR.
+        releaseBuffer(&rxCallbackCtx_, bufferIndex);
 
-        while (!seq.empty() && seq.front() < 0)
-        {
-            seq.erase(seq.begin());
-        }
-        normalizeSeq(seq);
-        if (seq.empty() || seq.front() < 0)
+        if (arena_->spanCount == 0)
         {
             return false;
         }
@@ -1096,176 +2312,136 @@ namespace esp32ir
             ESP_LOGW(kTag, "RX buffer truncated (symbols=%zu cap=%zu)", static_cast<size_t>(ev.num_symbols), rxBufferSymbols_);
             overflowed = true;
         }
-
-        RxParams params{};
-        params.frameGapUs = effFrameGapUs_;
-        params.hardGapUs = effHardGapUs_;
-        params.minFrameUs = effMinFrameUs_;
-        params.maxFrameUs = effMaxFrameUs_;
-        params.minEdges = effMinEdges_;
-        params.frameCountMax = effFrameCountMax_;
-        params.splitPolicy = effSplitPolicy_;
-        if (params.frameGapUs == 0)
+        // Every frame of an event shares the event's final overflow state.
+        for (size_t i = 0; i < arena_->spanCount; ++i)
         {
-            RxParams def = defaultParams(useRawOnly_ || useRawPlusKnown_);
-            params = def;
+            arena_->spans[(arena_->spanHead + i) % arena_->spans.size()].overflowed = overflowed;
         }
+        return decodePendingSpan(out);
+    }
 
-        std::vector<std::vector<int8_t>> framesData;
-        std::vector<int8_t> current;
-        uint32_t currentTimeUs = 0;
-        uint32_t spaceRunUs = 0;
-        size_t spaceRunStartIndex = 0;
-        uint32_t maxSpaceRunUs = 0;
-        // Allow a small tolerance when deciding gaps to cope with measurement jitter.
-        const uint32_t gapToleranceUs = params.frameGapUs ? std::max<uint32_t>(quantizeT_, params.frameGapUs / 20) : quantizeT_;
-        const uint32_t hardGapToleranceUs = params.hardGapUs ? std::max<uint32_t>(quantizeT_, params.hardGapUs / 20) : quantizeT_;
-        auto flush = [&](bool &overflowFlag, bool allowShort)
+    bool Receiver::startDecodeTask()
+    {
+        if (!results_.init(resultQueueDepth_))
         {
-            if (!current.empty())
-            {
-                if (!appendFrameIfValid(current, quantizeT_, params, framesData, allowShort))
-                {
-                    overflowFlag = true;
-                }
-                current.clear();
-                currentTimeUs = 0;
-            }
-        };
-
-        for (size_t i = 0; i < seq.size(); ++i)
+            return false;
+        }
+        if (zeroAlloc_)
         {
-            int v = seq[i];
-            uint32_t durUs = static_cast<uint32_t>((v < 0 ? -v : v) * quantizeT_);
-            bool isSpace = v < 0;
+            // Let the task fill result slots without growing them.
+            const uint16_t entries = static_cast<uint16_t>(std::min<size_t>((arenaSymbols_ ? arenaSymbols_ : rxBufferSymbols_) * 4, UINT16_MAX));
+            results_.forEachSlot([entries](esp32ir::RxResult &slot)
+                                 {
+                                     slot.raw.reserve(1, entries);
+                                     slot.payloadStorage.reserve(esp32ir::StaticRxResult<1>::kPayloadReserve);
+                                 });
+        }
+        decodeLock_ = xSemaphoreCreateMutex();
+        decodeTaskDone_ = xSemaphoreCreateBinary();
+        resultReady_ = xSemaphoreCreateBinary();
+        decodeTaskStop_ = false;
+        if (!decodeLock_ || !decodeTaskDone_ || !resultReady_)
+        {
+            stopDecodeTask();
+            return false;
+        }
+        BaseType_t core = decodeTaskCore_ < 0 ? tskNO_AFFINITY : static_cast<BaseType_t>(decodeTaskCore_);
+        if (xTaskCreatePinnedToCore(decodeTaskEntry, "ir_rx_decode", decodeTaskStackBytes_, this, decodeTaskPriority_, &decodeTask_, core) != pdPASS)
+        {
+            decodeTask_ = nullptr;
+            stopDecodeTask();
+            return false;
+        }
+        return true;
+    }
 
-            if (isSpace)
-            {
-                if (spaceRunUs == 0)
-                {
-                    spaceRunStartIndex = current.size();
-                }
-                spaceRunUs += durUs;
-                if (spaceRunUs > maxSpaceRunUs)
-                {
-                    maxSpaceRunUs = spaceRunUs;
-                }
-            }
-            else
-            {
-                spaceRunUs = 0;
-            }
+    void Receiver::stopDecodeTask()
+    {
+        if (decodeTask_)
+        {
+            decodeTaskStop_ = true;
+            xSemaphoreTake(decodeTaskDone_, portMAX_DELAY);
+            decodeTask_ = nullptr;
+        }
+        if (decodeLock_)
+        {
+            vSemaphoreDelete(decodeLock_);
+            decodeLock_ = nullptr;
+        }
+        if (decodeTaskDone_)
+        {
+            vSemaphoreDelete(decodeTaskDone_);
+            decodeTaskDone_ = nullptr;
+        }
+        if (resultReady_)
+        {
+            vSemaphoreDelete(resultReady_);
+            resultReady_ = nullptr;
+        }
+        results_.release();
+    }
 
-            bool forceSplit = false;
-            if (isSpace && params.hardGapUs > 0 && (spaceRunUs + hardGapToleranceUs) >= params.hardGapUs)
-            {
-                forceSplit = true;
-            }
-            else if (isSpace && params.maxFrameUs > 0 && (currentTimeUs + durUs) > params.maxFrameUs && !current.empty())
-            {
-                forceSplit = true;
-            }
+    void Receiver::decodeTaskEntry(void *arg)
+    {
+        auto *self = static_cast<Receiver *>(arg);
+        self->runDecodeTask();
+        xSemaphoreGive(self->decodeTaskDone_);
+        vTaskDelete(nullptr);
+    }
 
-            if (forceSplit && !current.empty())
-            {
-                if (params.splitPolicy == esp32ir::RxSplitPolicy::KEEP_GAP_IN_FRAME)
-                {
-                    current.push_back(static_cast<int8_t>(v));
-                    currentTimeUs += durUs;
-                }
-                else
+    void Receiver::runDecodeTask()
+    {
+        // Bounded wait so end() is noticed promptly.
+        const TickType_t kWaitTicks = pdMS_TO_TICKS(20);
+        while (!decodeTaskStop_)
+        {
+            rmt_rx_done_event_data_t ev = {};
+            xSemaphoreTake(decodeLock_, portMAX_DELAY);
+            const bool pending = arena_->spanCount > 0;
+            if (!pending)
+            {
+                applyPendingConfig();
+                xSemaphoreGive(decodeLock_);
+                if (!takeEvent(ev))
                 {
-                    // drop the accumulated gap from the frame
-                    if (current.size() > spaceRunStartIndex)
-                    {
-                        current.resize(spaceRunStartIndex);
-                    }
-                    if (currentTimeUs > spaceRunUs)
+                    if (xSemaphoreTake(rxWake_, kWaitTicks) == pdTRUE) // given by the ISR after each event
                     {
-                        currentTimeUs -= spaceRunUs;
-                    }
-                    else
-                    {
-                        currentTimeUs = 0;
+                        wakeUs_ = esp_timer_get_time();
                     }
+                    continue;
                 }
-                flush(overflowed, /*allowShort=*/true);
-                spaceRunUs = 0;
-                continue;
+                xSemaphoreTake(decodeLock_, portMAX_DELAY);
             }
-
-            if (current.empty() && isSpace)
+            // When poll() falls behind, the newest result is dropped and counted.
+            esp32ir::RxResult *slot = results_.writeSlot();
+            esp32ir::RxResult &target = slot ? *slot : droppedResult_;
+            const size_t before = heapBytes(target);
+            bool produced = pending ? decodePendingSpan(target) : processEvent(ev, target);
+            if (heapBytes(target) > before)
+            {
+                ++heapAllocCount_;
+            }
+            xSemaphoreGive(decodeLock_);
+            if (!produced)
             {
-                spaceRunUs = 0;
                 continue;
             }
-            current.push_back(static_cast<int8_t>(v));
-            currentTimeUs += durUs;
-
-            if (isSpace && params.frameGapUs > 0 && (spaceRunUs + gapToleranceUs) >= params.frameGapUs)
+            if (!subscribers_.empty())
             {
-                if (params.splitPolicy == esp32ir::RxSplitPolicy::KEEP_GAP_IN_FRAME)
-                {
-                    flush(overflowed, /*allowShort=*/true);
-                }
-                else
-                {
-                    // drop the accumulated gap from the frame
-                    if (current.size() >= spaceRunStartIndex)
-                    {
-                        current.resize(spaceRunStartIndex);
-                    }
-                    if (currentTimeUs > spaceRunUs)
-                    {
-                        currentTimeUs -= spaceRunUs;
-                    }
-                    else
-                    {
-                        currentTimeUs = 0;
-                    }
-                    flush(overflowed, /*allowShort=*/true);
-                }
-                spaceRunUs = 0;
+                deliver(target); // handlers take it; the slot is reused for the next result
+                continue;
             }
-        }
-        bool allowShortFinal = (current.size() < params.minEdges) && (currentTimeUs >= params.minFrameUs);
-        flush(overflowed, /*allowShort=*/allowShortFinal);
-
-        if (framesData.empty())
-        {
-            if (bufferIndex >= 0)
+            if (slot)
             {
-                rxPendingMask_ &= static_cast<uint8_t>(~(1u << bufferIndex));
+                deliver(target);
+                results_.publish();
+                xSemaphoreGive(resultReady_);
             }
-            return false;
-        }
-        std::vector<PendingSegment> newSegments;
-        newSegments.reserve(framesData.size());
-        for (const auto &fseq : framesData)
-        {
-            esp32ir::ITPSBuffer buf;
-            esp32ir::ITPSFrame frame{quantizeT_, static_cast<uint16_t>(fseq.size()), fseq.data(), 0};
-            buf.addFrame(frame);
-            newSegments.push_back({std::move(buf), overflowed});
-        }
-        if (newSegments.empty())
-        {
-            if (bufferIndex >= 0)
+            else
             {
-                rxPendingMask_ &= static_cast<uint8_t>(~(1u << bufferIndex));
+                ++droppedResults_;
             }
-            return false;
-        }
-        PendingSegment first = std::move(newSegments.front());
-        for (size_t i = 1; i < newSegments.size(); ++i)
-        {
-            pendingSegments_.push_back(std::move(newSegments[i]));
-        }
-        if (bufferIndex >= 0)
-        {
-            rxPendingMask_ &= static_cast<uint8_t>(~(1u << bufferIndex));
         }
-        return decode(first.raw, out, first.overflowed);
     }
 
 } // namespace esp32ir
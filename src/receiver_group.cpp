@@ -0,0 +1,169 @@
+#include "ESP32IRPulseCodec.h"
+#include <esp_timer.h>
+
+namespace esp32ir
+{
+
+    namespace
+    {
+        constexpr const char *kTag = "ESP32IRPulseCodec";
+    }
+
+    ReceiverGroup::~ReceiverGroup()
+    {
+        end();
+        for (auto *rx : members_)
+        {
+            rx->arena_ = &rx->ownArena_;
+            rx->group_ = nullptr;
+            rx->source_ = 0;
+        }
+    }
+
+    bool ReceiverGroup::add(Receiver &rx)
+    {
+        if (begun_ || rx.begun_ || rx.group_ || rx.decodeTaskEnabled_ || members_.size() >= kMaxSources)
+        {
+            ESP_LOGW(kTag, "RX group add rejected (group begun, receiver begun/grouped/decode task, or %u members)",
+                     static_cast<unsigned>(kMaxSources));
+            return false;
+        }
+        rx.group_ = this;
+        rx.source_ = static_cast<uint8_t>(members_.size());
+        rx.arena_ = &arena_;
+        members_.push_back(&rx);
+        return true;
+    }
+
+    bool ReceiverGroup::begin()
+    {
+        if (begun_)
+        {
+            ESP_LOGW(kTag, "RX group begin called while already begun");
+            return false;
+        }
+        if (members_.empty())
+        {
+            ESP_LOGE(kTag, "RX group begin failed: no receivers");
+            return false;
+        }
+        wake_ = xSemaphoreCreateBinary();
+        if (!wake_)
+        {
+            ESP_LOGE(kTag, "RX group begin failed: semaphore");
+            return false;
+        }
+        arena_ = Receiver::RxArena();
+        fanIn_.reset();
+        wakeUs_ = 0;
+        // Every member grows the shared arena to its own needs in begin().
+        for (size_t i = 0; i < members_.size(); ++i)
+        {
+            members_[i]->groupWake_ = wake_;
+            if (!members_[i]->begin())
+            {
+                ESP_LOGE(kTag, "RX group begin failed: receiver %u", static_cast<unsigned>(i));
+                for (size_t j = 0; j < i; ++j)
+                {
+                    members_[j]->end();
+                }
+                for (auto *rx : members_)
+                {
+                    rx->groupWake_ = nullptr;
+                }
+                vSemaphoreDelete(wake_);
+                wake_ = nullptr;
+                arena_ = Receiver::RxArena();
+                return false;
+            }
+        }
+        begun_ = true;
+        ESP_LOGI(kTag, "RX group begin receivers=%u", static_cast<unsigned>(members_.size()));
+        return true;
+    }
+
+    void ReceiverGroup::end()
+    {
+        if (!begun_)
+        {
+            return;
+        }
+        for (auto *rx : members_)
+        {
+            rx->end();
+            rx->groupWake_ = nullptr;
+        }
+        vSemaphoreDelete(wake_);
+        wake_ = nullptr;
+        arena_ = Receiver::RxArena();
+        fanIn_.reset();
+        begun_ = false;
+    }
+
+    bool ReceiverGroup::poll(esp32ir::RxResult &out)
+    {
+        wakeUs_ = 0; // nothing waited, so nothing to measure
+        return pollOnce(out);
+    }
+
+    bool ReceiverGroup::poll(esp32ir::RxResult &out, TickType_t timeoutTicks)
+    {
+        wakeUs_ = 0;
+        const TickType_t start = xTaskGetTickCount();
+        for (;;)
+        {
+            if (pollOnce(out))
+            {
+                return true;
+            }
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (!wake_ || (timeoutTicks != portMAX_DELAY && elapsed >= timeoutTicks))
+            {
+                return false;
+            }
+            if (xSemaphoreTake(wake_, timeoutTicks == portMAX_DELAY ? portMAX_DELAY : timeoutTicks - elapsed) == pdTRUE)
+            {
+                wakeUs_ = esp_timer_get_time();
+            }
+        }
+    }
+
+    bool ReceiverGroup::pollOnce(esp32ir::RxResult &out)
+    {
+        if (!begun_)
+        {
+            return false;
+        }
+        // Each pass converts one event or decodes one pending frame, so this ends once the members run dry.
+        for (;;)
+        {
+            const int source = fanIn_.next(members_.size(), [this](size_t i, int64_t &us)
+                                           { return members_[i]->peekEventUs(us); });
+            if (source < 0)
+            {
+                return false;
+            }
+            Receiver &rx = *members_[static_cast<size_t>(source)];
+            const bool queued = arena_.spanCount > 0 || rx.rxEvents_.size() > 0;
+            rx.wakeUs_ = wakeUs_;
+            const bool ok = rx.pollOnce(out); // tags out.source, calls the member's handlers
+            if (arena_.spanCount > 0 || arena_.streaming)
+            {
+                fanIn_.hold(static_cast<size_t>(source));
+            }
+            else
+            {
+                fanIn_.release();
+            }
+            if (ok)
+            {
+                return true;
+            }
+            if (!queued)
+            {
+                return false; // the held source waits for the next part of its capture
+            }
+        }
+    }
+
+} // namespace esp32ir
@@ -14,7 +14,10 @@ namespace esp32ir
         constexpr uint32_t kRmtDurationMax = 32767;
         constexpr rmt_clock_source_t kRmtClockSource = RMT_CLK_SRC_REF_TICK;
 
-        void pushSymbol(std::vector<rmt_symbol_word_t> &items, bool level, uint32_t durationUs)
+        constexpr size_t kTxBytesReserve = 16; // longest non-AC bitstream is 6 bytes
+
+        // maxItems: fixed symbol capacity (0: grow as needed). Returns false if the symbols do not fit.
+        bool pushSymbol(std::vector<rmt_symbol_word_t> &items, bool level, uint32_t durationUs, size_t maxItems)
         {
             uint32_t remaining = durationUs;
             while (remaining > 0)
@@ -22,6 +25,10 @@ namespace esp32ir
                 uint32_t chunk = remaining > kRmtDurationMax ? kRmtDurationMax : remaining;
                 if (items.empty() || items.back().duration1 != 0)
                 {
+                    if (maxItems > 0 && items.size() >= maxItems)
+                    {
+                        return false;
+                    }
                     rmt_symbol_word_t item = {};
                     item.level0 = level ? 1 : 0;
                     item.duration0 = chunk;
@@ -35,21 +42,26 @@ namespace esp32ir
                 }
                 remaining -= chunk;
             }
+            return true;
         }
 
-        void appendITPSFrame(std::vector<rmt_symbol_word_t> &items, const esp32ir::ITPSFrame &f)
+        bool appendITPSFrame(std::vector<rmt_symbol_word_t> &items, const esp32ir::ITPSFrame &f, size_t maxItems)
         {
             if (!f.seq || f.len == 0 || f.T_us == 0)
             {
-                return;
+                return true;
             }
             for (uint16_t i = 0; i < f.len; ++i)
             {
                 int v = f.seq[i];
                 uint32_t durUs = static_cast<uint32_t>((v < 0) ? -v : v) * static_cast<uint32_t>(f.T_us);
                 bool level = v > 0;
-                pushSymbol(items, level, durUs);
+                if (!pushSymbol(items, level, durUs, maxItems))
+                {
+                    return false;
+                }
             }
+            return true;
         }
 
         bool itpsFrameValid(const esp32ir::ITPSFrame &f)
@@ -73,7 +85,7 @@ namespace esp32ir
             return true;
         }
 
-        bool itpsValid(const esp32ir::ITPSBuffer &b)
+        bool itpsValid(const esp32ir::ITPSView &b)
         {
             if (b.frameCount() == 0)
             {
@@ -165,6 +177,13 @@ namespace esp32ir
         gapOverridden_ = true;
         return true;
     }
+    bool Transmitter::setTxBufferSymbols(size_t symbols)
+    {
+        if (begun_)
+            return false;
+        txBufferSymbols_ = symbols;
+        return true;
+    }
 
     bool Transmitter::begin()
     {
@@ -237,6 +256,18 @@ namespace esp32ir
             txChannel_ = nullptr;
             return false;
         }
+        // Working memory for the sends; with setTxBufferSymbols it is allocated here once and never grows.
+        txBytes_.reserve(kTxBytesReserve);
+        if (txBufferSymbols_ > 0)
+        {
+            txItems_.reserve(txBufferSymbols_);
+            txFrameEntries_.resize(txBufferSymbols_ * 2); // one entry per mark/space
+            txFrame_.useStorage(txFrameEntries_.data(), txFrameEntries_.size(), &txFrameSlot_, 1);
+        }
+        else
+        {
+            txFrame_.useStorage(nullptr, 0, nullptr, 0);
+        }
         ESP_LOGD(kTag, "TX init version=%s pin=%d invert=%s carrierHz=%lu duty=%u%% gapUs=%lu gapOverride=%s resolutionHz=%lu",
                  ESP32IRPULSECODEC_VERSION_STR,
                  txPin_, invertOutput_ ? "true" : "false",
@@ -274,7 +305,7 @@ namespace esp32ir
         ESP_LOGI(kTag, "TX end");
     }
 
-    bool Transmitter::sendWithGap(const esp32ir::ITPSBuffer &itps, uint32_t recommendedGapUs)
+    bool Transmitter::sendWithGap(const esp32ir::ITPSView &itps, uint32_t recommendedGapUs)
     {
         if (!begun_)
         {
@@ -283,26 +314,92 @@ namespace esp32ir
         }
         if (!itpsValid(itps))
         {
-            ESP_LOGE(kTag, "TX send failed: invalid ITPSBuffer");
+            ESP_LOGE(kTag, "TX send failed: invalid ITPS");
             return false;
         }
         uint32_t gapToUse = gapOverridden_ ? gapUs_ : (recommendedGapUs ? recommendedGapUs : gapUs_);
-        std::vector<rmt_symbol_word_t> items;
+        std::vector<rmt_symbol_word_t> &items = txItems_;
+        items.clear();
         uint64_t totalUs = 0;
         for (uint16_t i = 0; i < itps.frameCount(); ++i)
         {
             const auto &f = itps.frame(i);
-            appendITPSFrame(items, f);
+            if (!appendITPSFrame(items, f, txBufferSymbols_))
+            {
+                ESP_LOGE(kTag, "TX send failed: frame exceeds %u TX buffer symbols", static_cast<unsigned>(txBufferSymbols_));
+                return false;
+            }
             for (uint16_t j = 0; j < f.len; ++j)
             {
                 int v = f.seq[j];
                 totalUs += static_cast<uint64_t>(v < 0 ? -v : v) * static_cast<uint64_t>(f.T_us);
             }
         }
+        return transmitItems(totalUs, gapToUse);
+    }
+
+    bool Transmitter::send(const esp32ir::CompactITPSView &itps)
+    {
+        if (!begun_)
+        {
+            ESP_LOGE(kTag, "TX send called before begin");
+            return false;
+        }
+        // Symbols are built while the entries are unpacked; nothing goes out until every frame has been checked.
+        const uint16_t count = itps.frameCount();
+        if (count == 0)
+        {
+            ESP_LOGE(kTag, "TX send failed: invalid compact ITPS");
+            return false;
+        }
+        txItems_.clear();
+        uint64_t totalUs = 0;
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            esp32ir::CompactITPSView::Reader r = itps.frame(i);
+            if (r.T_us() == 0 || r.len() == 0)
+            {
+                ESP_LOGE(kTag, "TX send failed: invalid compact ITPS");
+                return false;
+            }
+            int8_t v = 0;
+            uint16_t read = 0;
+            while (r.next(v))
+            {
+                if (v == 0 || v == -128 || (read == 0 && v < 0))
+                {
+                    ESP_LOGE(kTag, "TX send failed: invalid compact ITPS");
+                    return false;
+                }
+                ++read;
+                uint32_t durUs = static_cast<uint32_t>(v < 0 ? -v : v) * static_cast<uint32_t>(r.T_us());
+                if (!pushSymbol(txItems_, v > 0, durUs, txBufferSymbols_))
+                {
+                    ESP_LOGE(kTag, "TX send failed: frame exceeds %u TX buffer symbols", static_cast<unsigned>(txBufferSymbols_));
+                    return false;
+                }
+                totalUs += durUs;
+            }
+            if (read != r.len())
+            {
+                ESP_LOGE(kTag, "TX send failed: invalid compact ITPS");
+                return false;
+            }
+        }
+        return transmitItems(totalUs, gapUs_);
+    }
+
+    bool Transmitter::transmitItems(uint64_t totalUs, uint32_t gapToUse)
+    {
+        std::vector<rmt_symbol_word_t> &items = txItems_;
         // enforce trailing gap as Space
         if (gapToUse > 0)
         {
-            pushSymbol(items, false, gapToUse);
+            if (!pushSymbol(items, false, gapToUse, txBufferSymbols_))
+            {
+                ESP_LOGE(kTag, "TX send failed: frame exceeds %u TX buffer symbols", static_cast<unsigned>(txBufferSymbols_));
+                return false;
+            }
             totalUs += gapToUse;
         }
         if (items.empty())
@@ -335,11 +432,21 @@ namespace esp32ir
         return true;
     }
 
+    bool Transmitter::sendEncoded(const esp32ir::ITPSBuffer &frame, esp32ir::Protocol proto)
+    {
+        if (frame.overflowed())
+        {
+            ESP_LOGE(kTag, "TX send failed: frame exceeds %u TX buffer symbols", static_cast<unsigned>(txBufferSymbols_));
+            return false;
+        }
+        return sendWithGap(frame, recommendedGapUs(proto));
+    }
+
     uint32_t Transmitter::recommendedGapUs(esp32ir::Protocol proto) const
     {
         return defaultGapForProtocol(proto);
     }
-    bool Transmitter::send(const esp32ir::ITPSBuffer &itps)
+    bool Transmitter::send(const esp32ir::ITPSView &itps)
     {
         return sendWithGap(itps, 0);
     }
@@ -357,6 +464,7 @@ namespace esp32ir
         }
         switch (message.protocol)
         {
+#if ESP32IR_ENABLE_NEC
         case esp32ir::Protocol::NEC:
         {
             if (message.length != sizeof(esp32ir::payload::NEC))
@@ -369,6 +477,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendNEC(p);
         }
+#endif
+#if ESP32IR_ENABLE_SONY
         case esp32ir::Protocol::SONY:
         {
             if (message.length != sizeof(esp32ir::payload::SONY))
@@ -381,6 +491,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendSONY(p);
         }
+#endif
+#if ESP32IR_ENABLE_AEHA
         case esp32ir::Protocol::AEHA:
         {
             if (message.length != sizeof(esp32ir::payload::AEHA))
@@ -393,6 +505,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendAEHA(p);
         }
+#endif
+#if ESP32IR_ENABLE_PANASONIC
         case esp32ir::Protocol::Panasonic:
         {
             if (message.length != sizeof(esp32ir::payload::Panasonic))
@@ -405,6 +519,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendPanasonic(p);
         }
+#endif
+#if ESP32IR_ENABLE_JVC
         case esp32ir::Protocol::JVC:
         {
             if (message.length != sizeof(esp32ir::payload::JVC))
@@ -417,6 +533,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendJVC(p);
         }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG
         case esp32ir::Protocol::Samsung:
         {
             if (message.length != sizeof(esp32ir::payload::Samsung))
@@ -429,6 +547,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendSamsung(p);
         }
+#endif
+#if ESP32IR_ENABLE_SAMSUNG36
         case esp32ir::Protocol::Samsung36:
         {
             if (message.length != sizeof(esp32ir::payload::Samsung36))
@@ -441,6 +561,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendSamsung36(p);
         }
+#endif
+#if ESP32IR_ENABLE_LG
         case esp32ir::Protocol::LG:
         {
             if (message.length != sizeof(esp32ir::payload::LG))
@@ -453,6 +575,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendLG(p);
         }
+#endif
+#if ESP32IR_ENABLE_DENON
         case esp32ir::Protocol::Denon:
         {
             if (message.length != sizeof(esp32ir::payload::Denon))
@@ -465,6 +589,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendDenon(p);
         }
+#endif
+#if ESP32IR_ENABLE_RC5
         case esp32ir::Protocol::RC5:
         {
             if (message.length != sizeof(esp32ir::payload::RC5))
@@ -477,6 +603,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendRC5(p);
         }
+#endif
+#if ESP32IR_ENABLE_RC6
         case esp32ir::Protocol::RC6:
         {
             if (message.length != sizeof(esp32ir::payload::RC6))
@@ -489,6 +617,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendRC6(p);
         }
+#endif
+#if ESP32IR_ENABLE_APPLE
         case esp32ir::Protocol::Apple:
         {
             if (message.length != sizeof(esp32ir::payload::Apple))
@@ -501,6 +631,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendApple(p);
         }
+#endif
+#if ESP32IR_ENABLE_PIONEER
         case esp32ir::Protocol::Pioneer:
         {
             if (message.length != sizeof(esp32ir::payload::Pioneer))
@@ -513,6 +645,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendPioneer(p);
         }
+#endif
+#if ESP32IR_ENABLE_TOSHIBA
         case esp32ir::Protocol::Toshiba:
         {
             if (message.length != sizeof(esp32ir::payload::Toshiba))
@@ -525,6 +659,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendToshiba(p);
         }
+#endif
+#if ESP32IR_ENABLE_MITSUBISHI
         case esp32ir::Protocol::Mitsubishi:
         {
             if (message.length != sizeof(esp32ir::payload::Mitsubishi))
@@ -537,6 +673,8 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendMitsubishi(p);
         }
+#endif
+#if ESP32IR_ENABLE_HITACHI
         case esp32ir::Protocol::Hitachi:
         {
             if (message.length != sizeof(esp32ir::payload::Hitachi))
@@ -549,6 +687,7 @@ namespace esp32ir
             std::memcpy(&p, message.data, sizeof(p));
             return sendHitachi(p);
         }
+#endif
         default:
             ESP_LOGW(kTag, "TX send ProtocolMessage stub: encode/HAL not implemented (protocol=%u, len=%u)",
                      static_cast<unsigned>(message.protocol),
@@ -0,0 +1,49 @@
+#pragma once
+// Captures of examples/04_decode_test_runner/assets (capture.durationsUs of each JSON file).
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Asset
+{
+  std::string name;
+  std::vector<int> us;
+};
+
+inline std::vector<Asset> loadAssets(const std::string &dir = ASSET_DIR)
+{
+  std::vector<Asset> out;
+  for (auto &e : std::filesystem::recursive_directory_iterator(dir))
+  {
+    if (e.path().extension() != ".json")
+      continue;
+    std::ifstream in(e.path());
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string s = ss.str();
+    size_t p = s.find("\"durationsUs\"");
+    if (p == std::string::npos || (p = s.find('[', p)) == std::string::npos)
+      continue;
+    Asset a{e.path().filename().string(), {}};
+    const char *c = s.c_str() + p + 1;
+    while (*c && *c != ']')
+    {
+      char *end = nullptr;
+      long v = std::strtol(c, &end, 10);
+      if (end == c)
+      {
+        ++c;
+        continue;
+      }
+      a.us.push_back(static_cast<int>(v));
+      c = end;
+    }
+    out.push_back(a);
+  }
+  std::sort(out.begin(), out.end(), [](const Asset &a, const Asset &b) { return a.name < b.name; });
+  return out;
+}
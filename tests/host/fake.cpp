@@ -0,0 +1,130 @@
+// Host fakes for ESP-IDF / FreeRTOS primitives (test harness only).
+#include "Arduino.h"
+#include "driver/rmt_rx.h"
+#include "driver/rmt_tx.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "fake.h"
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <atomic>
+
+static auto t0 = std::chrono::steady_clock::now();
+int64_t fake_time_offset_us = 0;
+int64_t esp_timer_get_time(void) { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count() + fake_time_offset_us; }
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) { return (esp_cpu_cycle_count_t)(esp_timer_get_time() * 240); }
+unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+unsigned long micros() { return (unsigned long)esp_timer_get_time(); }
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+struct QueueDef { std::mutex m; std::condition_variable cv; std::deque<std::vector<uint8_t>> q; size_t len, item; int count = 0; int maxCount = 0; bool isSem = false; };
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t itemSize) { auto *q = new QueueDef; q->len = len; q->item = itemSize; return q; }
+void vQueueDelete(QueueHandle_t q) { delete q; }
+static BaseType_t qsend(QueueHandle_t q, const void *p) { std::lock_guard<std::mutex> l(q->m); if (q->q.size() >= q->len) return pdFALSE; q->q.emplace_back((const uint8_t *)p, (const uint8_t *)p + q->item); q->cv.notify_all(); return pdTRUE; }
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *p, BaseType_t *w) { if (w) *w = pdFALSE; return qsend(q, p); }
+BaseType_t xQueueSend(QueueHandle_t q, const void *p, TickType_t) { return qsend(q, p); }
+BaseType_t xQueueReceiveFromISR(QueueHandle_t q, void *p, BaseType_t *) { std::lock_guard<std::mutex> l(q->m); if (q->q.empty()) return pdFALSE; memcpy(p, q->q.front().data(), q->item); q->q.pop_front(); return pdTRUE; }
+BaseType_t xQueueReceive(QueueHandle_t q, void *p, TickType_t t) {
+  std::unique_lock<std::mutex> l(q->m);
+  if (q->q.empty()) { if (t == 0) return pdFALSE; if (t == portMAX_DELAY) q->cv.wait(l, [&]{ return !q->q.empty(); }); else if (!q->cv.wait_for(l, std::chrono::milliseconds(t), [&]{ return !q->q.empty(); })) return pdFALSE; }
+  memcpy(p, q->q.front().data(), q->item); q->q.pop_front(); return pdTRUE; }
+UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t q) { std::lock_guard<std::mutex> l(q->m); return q->q.size(); }
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { std::lock_guard<std::mutex> l(q->m); return q->q.size(); }
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { auto *q = new QueueDef; q->isSem = true; q->maxCount = 1; return q; }
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t mx, UBaseType_t init) { auto *q = new QueueDef; q->isSem = true; q->maxCount = mx; q->count = init; return q; }
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { auto *q = new QueueDef; q->isSem = true; q->maxCount = 1; q->count = 1; return q; }
+void vSemaphoreDelete(SemaphoreHandle_t s) { delete s; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t t) {
+  std::unique_lock<std::mutex> l(s->m);
+  auto ok = [&]{ return s->count > 0; };
+  if (!ok()) { if (t == 0) return pdFALSE; if (t == portMAX_DELAY) s->cv.wait(l, ok); else if (!s->cv.wait_for(l, std::chrono::milliseconds(t), ok)) return pdFALSE; }
+  --s->count; return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) { std::lock_guard<std::mutex> l(s->m); if (s->count >= s->maxCount) return pdFALSE; ++s->count; s->cv.notify_all(); return pdTRUE; }
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t *w) { if (w) *w = pdFALSE; return xSemaphoreGive(s); }
+
+struct TaskDef { std::thread th; };
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *, uint32_t, void *arg, UBaseType_t, TaskHandle_t *h, BaseType_t) {
+  auto *t = new TaskDef; t->th = std::thread(fn, arg); t->th.detach(); if (h) *h = t; return pdPASS; }
+void vTaskDelete(TaskHandle_t) {}
+void vTaskDelay(TickType_t t) { std::this_thread::sleep_for(std::chrono::milliseconds(t)); }
+TickType_t xTaskGetTickCount(void) { return (TickType_t)millis(); }
+
+// --- RMT fake ---
+struct rmt_channel_t { bool rx; rmt_rx_done_callback_t cb = nullptr; void *ctx = nullptr; rmt_symbol_word_t *buf = nullptr; size_t cap = 0; bool armed = false; rmt_receive_config_t cfg{}; };
+rmt_channel_t *g_rx = nullptr;
+std::vector<rmt_symbol_word_t> g_tx;
+std::vector<rmt_channel_t *> g_rxs; // every open RX channel, in creation order
+esp_err_t rmt_new_rx_channel(const rmt_rx_channel_config_t *, rmt_channel_handle_t *h) { *h = new rmt_channel_t{true}; g_rx = *h; g_rxs.push_back(*h); return ESP_OK; }
+// Direct the inject functions at the i-th open RX channel.
+bool fake_rmt_select(size_t i) { if (i >= g_rxs.size()) return false; g_rx = g_rxs[i]; return true; }
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *, rmt_channel_handle_t *h) { *h = new rmt_channel_t{false}; return ESP_OK; }
+esp_err_t rmt_del_channel(rmt_channel_handle_t h) { if (h == g_rx) g_rx = nullptr; for (size_t i = 0; i < g_rxs.size(); ++i) if (g_rxs[i] == h) { g_rxs.erase(g_rxs.begin() + i); break; } delete h; return ESP_OK; }
+esp_err_t rmt_enable(rmt_channel_handle_t) { return ESP_OK; }
+esp_err_t rmt_disable(rmt_channel_handle_t) { return ESP_OK; }
+esp_err_t rmt_apply_carrier(rmt_channel_handle_t, const rmt_carrier_config_t *) { return ESP_OK; }
+esp_err_t rmt_receive(rmt_channel_handle_t h, void *b, size_t bytes, const rmt_receive_config_t *c) {
+  if (h->armed) return ESP_ERR_INVALID_STATE;
+  h->buf = (rmt_symbol_word_t *)b; h->cap = bytes / sizeof(rmt_symbol_word_t); h->armed = true; h->cfg = *c; return ESP_OK; }
+esp_err_t rmt_rx_register_event_callbacks(rmt_channel_handle_t h, const rmt_rx_event_callbacks_t *cbs, void *ctx) { h->cb = cbs->on_recv_done; h->ctx = ctx; return ESP_OK; }
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *, rmt_encoder_handle_t *h) { *h = (rmt_encoder_handle_t)0x1; return ESP_OK; }
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t) { return ESP_OK; }
+esp_err_t rmt_transmit(rmt_channel_handle_t, rmt_encoder_handle_t, const void *p, size_t bytes, const rmt_transmit_config_t *) {
+  const auto *s = (const rmt_symbol_word_t *)p; g_tx.assign(s, s + bytes / sizeof(rmt_symbol_word_t)); return ESP_OK; }
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t, int) { return ESP_OK; }
+
+// Inject a capture (in ticks, sign = level) into the armed RX buffer and fire the callback.
+// Returns false when no buffer is armed (frame lost, as on hardware).
+bool fake_rmt_inject(const std::vector<int> &ticks, bool isLast)
+{
+  if (!g_rx || !g_rx->armed) return false;
+  size_t n = 0;
+  for (size_t i = 0; i < ticks.size() && n < g_rx->cap; i += 2, ++n) {
+    rmt_symbol_word_t s{};
+    s.level0 = ticks[i] > 0; s.duration0 = (uint16_t)std::abs(ticks[i]);
+    if (i + 1 < ticks.size()) { s.level1 = ticks[i + 1] > 0; s.duration1 = (uint16_t)std::abs(ticks[i + 1]); }
+    g_rx->buf[n] = s;
+  }
+  g_rx->armed = false;
+  rmt_rx_done_event_data_t ev{}; ev.received_symbols = g_rx->buf; ev.num_symbols = n; ev.flags.is_last = isLast;
+  g_rx->cb(g_rx, &ev, g_rx->ctx);
+  return true;
+}
+uint32_t fake_rmt_idle_ns() { return g_rx ? g_rx->cfg.signal_range_max_ns : 0; }
+// Partial RX (en_partial_rx): the driver refills the same user buffer and reports it each time it is full
+// (is_last=false); the final remainder comes with is_last=true. Returns false when no buffer is armed.
+std::function<void()> g_between_chunks;
+bool fake_rmt_inject_partial(const std::vector<int> &ticks)
+{
+  if (!g_rx || !g_rx->armed) return false;
+  std::vector<rmt_symbol_word_t> syms;
+  for (size_t i = 0; i < ticks.size(); i += 2) {
+    rmt_symbol_word_t s{};
+    s.level0 = ticks[i] > 0; s.duration0 = (uint16_t)std::abs(ticks[i]);
+    if (i + 1 < ticks.size()) { s.level1 = ticks[i + 1] > 0; s.duration1 = (uint16_t)std::abs(ticks[i + 1]); }
+    syms.push_back(s);
+  }
+  rmt_channel_t *ch = g_rx; rmt_symbol_word_t *buf = ch->buf; size_t cap = ch->cap; size_t off = 0;
+  for (size_t i = 0; i < syms.size(); ++i) {
+    buf[off++] = syms[i];
+    if (off == cap && i + 1 < syms.size()) {
+      rmt_rx_done_event_data_t ev{}; ev.received_symbols = buf; ev.num_symbols = cap; ev.flags.is_last = false;
+      ch->cb(ch, &ev, ch->ctx); off = 0;
+      if (g_between_chunks) g_between_chunks();
+    }
+  }
+  ch->armed = false;
+  rmt_rx_done_event_data_t ev{}; ev.received_symbols = buf; ev.num_symbols = off; ev.flags.is_last = true;
+  ch->cb(ch, &ev, ch->ctx);
+  return true;
+}
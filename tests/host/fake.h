@@ -0,0 +1,15 @@
+#pragma once
+// Test-side interface of fake.cpp.
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Inject a capture (RMT ticks, sign = level) into the armed RX buffer in one callback.
+bool fake_rmt_inject(const std::vector<int> &ticks, bool isLast = true);
+// Inject a capture as partial-RX chunks of the armed buffer size (needs -DHOST_PINGPONG).
+bool fake_rmt_inject_partial(const std::vector<int> &ticks);
+// Direct the inject functions at the i-th open RX channel.
+bool fake_rmt_select(size_t i);
+// Called after every partial-RX chunk but the last.
+extern std::function<void()> g_between_chunks;
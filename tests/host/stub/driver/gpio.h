@@ -0,0 +1,2 @@
+#pragma once
+typedef int gpio_num_t;
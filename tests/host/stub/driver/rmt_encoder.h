@@ -0,0 +1,5 @@
+#pragma once
+#include "driver/rmt_types.h"
+typedef struct { int dummy; } rmt_copy_encoder_config_t;
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *, rmt_encoder_handle_t *);
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t);
@@ -0,0 +1,11 @@
+#pragma once
+#include "driver/rmt_common.h"
+#include "driver/rmt_encoder.h"
+typedef struct {
+  gpio_num_t gpio_num; rmt_clock_source_t clk_src; uint32_t resolution_hz; size_t mem_block_symbols; size_t trans_queue_depth; int intr_priority;
+  struct { uint32_t invert_out : 1; uint32_t with_dma : 1; uint32_t io_loop_back : 1; uint32_t io_od_mode : 1; uint32_t allow_pd : 1; uint32_t init_level : 1; } flags;
+} rmt_tx_channel_config_t;
+typedef struct { int loop_count; struct { uint32_t eot_level : 1; uint32_t queue_nonblocking : 1; } flags; } rmt_transmit_config_t;
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *, rmt_channel_handle_t *);
+esp_err_t rmt_transmit(rmt_channel_handle_t, rmt_encoder_handle_t, const void *, size_t, const rmt_transmit_config_t *);
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t, int);
@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "soc/soc_caps.h"
+typedef union {
+  struct {
+    uint16_t duration0 : 15;
+    uint16_t level0 : 1;
+    uint16_t duration1 : 15;
+    uint16_t level1 : 1;
+  };
+  uint32_t val;
+} rmt_symbol_word_t;
+typedef struct rmt_channel_t *rmt_channel_handle_t;
+typedef struct rmt_encoder_t *rmt_encoder_handle_t;
+typedef enum { RMT_CLK_SRC_DEFAULT = 0, RMT_CLK_SRC_REF_TICK = 1, RMT_CLK_SRC_APB = 2 } rmt_clock_source_t;
+typedef struct {
+  rmt_symbol_word_t *received_symbols;
+  size_t num_symbols;
+  struct { uint32_t is_last : 1; } flags;
+} rmt_rx_done_event_data_t;
+typedef bool (*rmt_rx_done_callback_t)(rmt_channel_handle_t, const rmt_rx_done_event_data_t *, void *);
+typedef struct { bool dummy; } rmt_tx_done_event_data_t;
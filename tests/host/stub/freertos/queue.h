@@ -0,0 +1,11 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+typedef struct QueueDef *QueueHandle_t;
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t);
+BaseType_t xQueueSendFromISR(QueueHandle_t, const void *, BaseType_t *);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t, void *, BaseType_t *);
+BaseType_t xQueueReceive(QueueHandle_t, void *, TickType_t);
+BaseType_t xQueueSend(QueueHandle_t, const void *, TickType_t);
+UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t);
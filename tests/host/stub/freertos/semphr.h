@@ -0,0 +1,10 @@
+#pragma once
+#include "freertos/queue.h"
+typedef QueueHandle_t SemaphoreHandle_t;
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t, UBaseType_t);
+void vSemaphoreDelete(SemaphoreHandle_t);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t, BaseType_t *);
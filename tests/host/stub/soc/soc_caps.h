@@ -0,0 +1,4 @@
+#pragma once
+#ifdef HOST_PINGPONG
+#define SOC_RMT_SUPPORT_RX_PINGPONG 1
+#endif
@@ -0,0 +1,138 @@
+// Compact ITPS: lossless round trip of the example captures, the same pulses and RMT symbols as the plain frames,
+// and rejection of malformed bytes.
+#include "ESP32IRPulseCodec.h"
+#include "assets.h"
+#include "driver/rmt_tx.h"
+#include <cstdio>
+#include <cstring>
+
+extern std::vector<rmt_symbol_word_t> g_tx;
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+// One ITPS frame per capture at T us, runs above 127 counts split as the receiver does.
+static esp32ir::ITPSBuffer toITPS(const std::vector<int> &us, uint16_t T)
+{
+  esp32ir::ITPSBuffer b;
+  b.beginFrame(T);
+  for (int v : us)
+  {
+    int m = (std::abs(v) + T / 2) / T;
+    if (m == 0)
+      m = 1;
+    while (m > 127)
+    {
+      b.appendEntry(v > 0 ? 127 : -127);
+      m -= 127;
+    }
+    b.appendEntry(static_cast<int8_t>(v > 0 ? m : -m));
+  }
+  return b;
+}
+
+static bool same(const esp32ir::ITPSBuffer &a, const esp32ir::ITPSBuffer &b)
+{
+  if (a.frameCount() != b.frameCount())
+    return false;
+  for (uint16_t i = 0; i < a.frameCount(); ++i)
+  {
+    const auto &x = a.frame(i);
+    const auto &y = b.frame(i);
+    if (x.T_us != y.T_us || x.len != y.len || x.flags != y.flags || memcmp(x.seq, y.seq, x.len) != 0)
+      return false;
+  }
+  return true;
+}
+
+static void testRoundTrip(const std::vector<Asset> &assets)
+{
+  esp32ir::Transmitter tx(5);
+  tx.begin();
+  for (uint16_t T : {5, 10, 50})
+  {
+    for (auto &a : assets)
+    {
+      const auto plain = toITPS(a.us, T);
+      esp32ir::CompactITPS c;
+      EXPECT(c.assign(plain), "%s T=%u: assign", a.name.c_str(), T);
+      esp32ir::ITPSBuffer back;
+      EXPECT(c.view().unpack(back) && same(back, plain), "%s T=%u: unpack differs", a.name.c_str(), T);
+      EXPECT(c.view().totalTimeUs() == plain.totalTimeUs(), "%s T=%u: totalTimeUs", a.name.c_str(), T);
+      esp32ir::Pulse p1[256];
+      esp32ir::Pulse p2[256];
+      auto v1 = esp32ir::makePulseView(plain, p1, 256);
+      auto v2 = esp32ir::makePulseView(c, p2, 256);
+      bool eq = v1.size() == v2.size() && v1.size() > 0;
+      for (size_t i = 0; eq && i < v1.size(); ++i)
+        eq = v1[i].mark == v2[i].mark && v1[i].us == v2[i].us;
+      EXPECT(eq, "%s T=%u: pulses differ", a.name.c_str(), T);
+      g_tx.clear();
+      tx.send(plain);
+      const auto t1 = g_tx;
+      g_tx.clear();
+      tx.send(c);
+      EXPECT(!t1.empty() && t1.size() == g_tx.size() && memcmp(t1.data(), g_tx.data(), t1.size() * sizeof(rmt_symbol_word_t)) == 0,
+             "%s T=%u: RMT symbols differ", a.name.c_str(), T);
+    }
+  }
+  tx.end();
+}
+
+// Bytes that are not valid compact ITPS report no frames, and unpack() fails without producing any.
+static void testMalformed(const std::vector<Asset> &assets)
+{
+  esp32ir::CompactITPS c;
+  c.assign(toITPS(assets.front().us, 10));
+  const std::vector<uint8_t> good(c.view().data(), c.view().data() + c.view().size());
+  constexpr size_t kT = 3, kLen = 5, kMode = 8; // header of the first frame
+  struct Case
+  {
+    const char *name;
+    size_t at;
+    uint8_t value;
+  } cases[] = {
+      {"version", 0, 0xEE},
+      {"index bits 5", kMode, 5},
+      {"index bits 0 with offsets", kMode, 1 << 3},
+      {"T_us 0", kT, 0},
+      {"len 0", kLen, 0},
+  };
+  for (auto &k : cases)
+  {
+    auto bytes = good;
+    bytes[k.at] = k.value;
+    if (k.at == kT || k.at == kLen)
+      bytes[k.at + 1] = 0;
+    esp32ir::CompactITPSView v(bytes.data(), bytes.size());
+    esp32ir::ITPSBuffer out;
+    const bool headerOnly = k.at == kT || k.at == kLen; // layout intact, contents unusable
+    EXPECT(headerOnly || v.frameCount() == 0, "%s: frameCount %u", k.name, v.frameCount());
+    EXPECT(!v.unpack(out), "%s: unpack accepted", k.name);
+  }
+  esp32ir::CompactITPSView truncated(good.data(), good.size() - 1);
+  esp32ir::ITPSBuffer out;
+  EXPECT(truncated.frameCount() == 0 && !truncated.unpack(out), "truncated bytes accepted");
+}
+
+int main()
+{
+  const auto assets = loadAssets();
+  EXPECT(!assets.empty(), "no assets under %s", ASSET_DIR);
+  if (!assets.empty())
+  {
+    testRoundTrip(assets);
+    testMalformed(assets);
+  }
+  printf("test_compact: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+// RxFanIn with simulated sources: captures come out oldest stamp first, a held source is taken until it is
+// released, and equal stamps go round-robin. Then a ReceiverGroup of three differently configured receivers,
+// fed interleaved captures through the fake RMT, must return each member's results as the member alone would,
+// in the order the captures were queued, and finish a capture arriving in partial-RX chunks before the next.
+#include "ESP32IRPulseCodec.h"
+#include "assets.h"
+#include "core/rx_fan_in.h"
+#include "fake.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+static std::vector<int> toTicks(const std::vector<int> &us, int T = 10)
+{
+  std::vector<int> t;
+  for (int v : us)
+    t.push_back(v < 0 ? -(-v / T) : v / T);
+  return t;
+}
+
+static std::string sig(const esp32ir::RxResult &r)
+{
+  std::string s = std::to_string(static_cast<int>(r.status)) + esp32ir::util::protocolToString(r.protocol);
+  for (unsigned i = 0; i < r.message.length; ++i)
+  {
+    char b[4];
+    snprintf(b, sizeof(b), "%02x", r.message.data[i]);
+    s += b;
+  }
+  for (uint16_t f = 0; f < r.raw.frameCount(); ++f)
+  {
+    s += "|" + std::to_string(r.raw.frame(f).T_us) + ":";
+    for (uint16_t i = 0; i < r.raw.frame(f).len; ++i)
+      s += std::to_string(r.raw.frame(f).seq[i]) + ",";
+  }
+  return s;
+}
+
+// Sources hold ascending stamps; draining through next() must yield every stamp once, globally sorted.
+static void testOldestFirst()
+{
+  std::mt19937 rng(7);
+  for (int trial = 0; trial < 2000; ++trial)
+  {
+    const size_t n = 1 + rng() % 8;
+    std::vector<std::vector<int64_t>> q(n);
+    std::vector<int64_t> all;
+    int64_t t = 0;
+    const int total = static_cast<int>(rng() % 40);
+    for (int k = 0; k < total; ++k)
+    {
+      t += 1 + rng() % 3;
+      q[rng() % n].push_back(t);
+      all.push_back(t);
+    }
+    esp32ir::RxFanIn f;
+    std::vector<size_t> pos(n, 0);
+    std::vector<int64_t> got;
+    for (int s; (s = f.next(n, [&](size_t i, int64_t &us)
+                            {
+                              if (pos[i] >= q[i].size())
+                                return false;
+                              us = q[i][pos[i]];
+                              return true; })) >= 0;)
+      got.push_back(q[s][pos[s]++]);
+    if (got != all)
+    {
+      EXPECT(false, "trial %d: %zu sources, %zu of %zu captures out of order", trial, n, got.size(), all.size());
+      return;
+    }
+  }
+}
+
+// A held source is returned even when it is empty or others are older; release() restores oldest-first.
+static void testHold()
+{
+  auto oldest = [](size_t i, int64_t &us)
+  {
+    us = static_cast<int64_t>(i);
+    return i != 2;
+  };
+  esp32ir::RxFanIn f;
+  EXPECT(f.held() < 0, "held before hold()");
+  f.hold(2);
+  EXPECT(f.held() == 2, "held() = %d", f.held());
+  EXPECT(f.next(3, oldest) == 2 && f.next(3, oldest) == 2, "held source not returned");
+  f.release();
+  EXPECT(f.held() < 0 && f.next(3, oldest) == 0, "release() does not restore oldest-first");
+  f.hold(1);
+  f.reset();
+  EXPECT(f.held() < 0 && f.next(3, oldest) == 0, "reset() keeps the hold");
+  EXPECT(f.next(3, [](size_t, int64_t &) { return false; }) == -1, "no source queued");
+}
+
+// Equal stamps rotate, starting after the source taken last.
+static void testTies()
+{
+  esp32ir::RxFanIn f;
+  std::string order;
+  for (int k = 0; k < 6; ++k)
+    order += std::to_string(f.next(3, [](size_t, int64_t &us)
+                                   {
+                                     us = 5;
+                                     return true; }));
+  EXPECT(order == "012012", "ties taken as %s", order.c_str());
+  // Source 1 empty: the rotation skips it.
+  order.clear();
+  f.reset();
+  for (int k = 0; k < 4; ++k)
+    order += std::to_string(f.next(3, [](size_t i, int64_t &us)
+                                   {
+                                     us = 5;
+                                     return i != 1; }));
+  EXPECT(order == "0202", "ties with an empty source taken as %s", order.c_str());
+}
+
+using Tagged = std::vector<std::pair<int, std::string>>;
+
+static void configure(esp32ir::Receiver &rx, int mode)
+{
+  if (mode == 1)
+    rx.useRawOnly();
+  if (mode == 2)
+    rx.useRawPlusKnown();
+  rx.setEventQueueDepth(16);
+  rx.setRxBufferCount(8);
+}
+
+// Results of each asset on a receiver of each mode, alone.
+static std::vector<std::vector<std::vector<std::string>>> standalone(const std::vector<Asset> &assets)
+{
+  std::vector<std::vector<std::vector<std::string>>> ref(3);
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    esp32ir::Receiver rx(4, false, 10);
+    configure(rx, mode);
+    rx.begin();
+    for (auto &a : assets)
+    {
+      fake_rmt_inject(toTicks(a.us));
+      std::vector<std::string> v;
+      esp32ir::RxResult r;
+      while (rx.poll(r))
+        v.push_back(sig(r));
+      ref[mode].push_back(v);
+    }
+    rx.end();
+  }
+  return ref;
+}
+
+// Members in KNOWN, RAW_ONLY and RAW_PLUS_KNOWN; captures land on random members between polls.
+static void testGroupInterleaved(const std::vector<Asset> &assets)
+{
+  const auto ref = standalone(assets);
+  esp32ir::Receiver a(4, false, 10), b(5, false, 10), c(6, false, 10);
+  esp32ir::Receiver *members[] = {&a, &b, &c};
+  esp32ir::ReceiverGroup g;
+  for (int i = 0; i < 3; ++i)
+  {
+    configure(*members[i], i);
+    EXPECT(g.add(*members[i]), "add member %d", i);
+  }
+  EXPECT(!g.add(a), "a member added twice");
+  EXPECT(g.begin(), "group begin");
+  std::mt19937 rng(3);
+  for (int round = 0; round < 30; ++round)
+  {
+    Tagged want;
+    const int k = 1 + static_cast<int>(rng() % 5);
+    for (int i = 0; i < k; ++i)
+    {
+      const int src = static_cast<int>(rng() % 3);
+      const size_t as = rng() % assets.size();
+      fake_rmt_select(src);
+      if (fake_rmt_inject(toTicks(assets[as].us)))
+        for (auto &s : ref[src][as])
+          want.push_back({src, s});
+      std::this_thread::sleep_for(std::chrono::microseconds(50)); // distinct ISR stamps
+    }
+    Tagged got;
+    esp32ir::RxResult r;
+    while (g.poll(r))
+      got.push_back({r.source, sig(r)});
+    if (got != want)
+    {
+      EXPECT(false, "round %d: %zu results, want %zu", round, got.size(), want.size());
+      for (size_t i = 0; i < std::min(got.size(), want.size()); ++i)
+        if (got[i] != want[i])
+        {
+          printf("  first difference at %zu: got source %d, want source %d\n", i, got[i].first, want[i].first);
+          break;
+        }
+      break;
+    }
+  }
+  g.end();
+}
+
+// Source 0 streams a capture in 8-symbol chunks; source 1 queues one in the middle of it. Source 0 keeps the
+// shared arena until its capture is complete, so all of its results come first.
+static void testGroupPartial(const std::vector<Asset> &assets)
+{
+  const auto ref = standalone(assets);
+  esp32ir::Receiver a(4, false, 10), b(5, false, 10);
+  for (auto *rx : {&a, &b})
+  {
+    configure(*rx, 2);
+    rx->setRxBufferSymbols(8);
+  }
+  esp32ir::ReceiverGroup g;
+  g.add(a);
+  g.add(b);
+  EXPECT(g.begin(), "group begin");
+  Tagged got;
+  esp32ir::RxResult r;
+  int chunks = 0;
+  g_between_chunks = [&]
+  {
+    while (g.poll(r))
+      got.push_back({r.source, sig(r)});
+    if (++chunks == 3)
+    {
+      fake_rmt_select(1);
+      fake_rmt_inject_partial(toTicks(assets.back().us));
+      fake_rmt_select(0);
+    }
+  };
+  fake_rmt_select(0);
+  fake_rmt_inject_partial(toTicks(assets.front().us));
+  g_between_chunks = nullptr;
+  while (g.poll(r))
+    got.push_back({r.source, sig(r)});
+  Tagged want;
+  for (auto &s : ref[2].front())
+    want.push_back({0, s});
+  for (auto &s : ref[2].back())
+    want.push_back({1, s});
+  EXPECT(chunks >= 3, "capture fit in %d chunks", chunks);
+  EXPECT(got == want, "partial: %zu results, want %zu", got.size(), want.size());
+  g.end();
+}
+
+int main()
+{
+  testOldestFirst();
+  testHold();
+  testTies();
+  const auto assets = loadAssets();
+  EXPECT(!assets.empty(), "no assets under %s", ASSET_DIR);
+  if (!assets.empty())
+  {
+    testGroupInterleaved(assets);
+    testGroupPartial(assets);
+  }
+  printf("test_fan_in: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+// No heap allocation after begin(): a zero-alloc Receiver polled into a StaticRxResult (with and without the
+// decode task, known-only and learning mode) and a Transmitter with a fixed TX buffer. operator new is
+// replaced to count every allocation made by the library, the decode task included.
+#include "ESP32IRPulseCodec.h"
+#include "assets.h"
+#include "driver/rmt_tx.h"
+#include "fake.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+static std::atomic<bool> g_counting{false};
+static std::atomic<size_t> g_allocs{0};
+static thread_local bool t_testSide = false; // the test's own bookkeeping on the main thread
+
+void *operator new(size_t n)
+{
+  if (g_counting.load(std::memory_order_relaxed) && !t_testSide)
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(n ? n : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+extern std::vector<rmt_symbol_word_t> g_tx;
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+// Counts allocations from construction to stop() (or destruction) outside the test's own bookkeeping.
+class Counting
+{
+public:
+  Counting()
+  {
+    g_allocs = 0;
+    g_counting = true;
+  }
+  ~Counting() { stop(); }
+  size_t stop()
+  {
+    g_counting = false;
+    return g_allocs.load();
+  }
+};
+
+static std::vector<int> toTicks(const std::vector<int> &us, int T = 10)
+{
+  std::vector<int> t;
+  for (int v : us)
+    t.push_back(v < 0 ? -(-v / T) : v / T);
+  return t;
+}
+
+static std::string sig(const esp32ir::RxResult &r)
+{
+  std::string s = std::to_string(static_cast<int>(r.status)) + esp32ir::util::protocolToString(r.protocol);
+  for (unsigned i = 0; i < r.message.length; ++i)
+  {
+    char b[4];
+    snprintf(b, sizeof(b), "%02x", r.message.data[i]);
+    s += b;
+  }
+  for (uint16_t f = 0; f < r.raw.frameCount(); ++f)
+  {
+    s += "|" + std::to_string(r.raw.frame(f).T_us) + ":";
+    for (uint16_t i = 0; i < r.raw.frame(f).len; ++i)
+      s += std::to_string(r.raw.frame(f).seq[i]) + ",";
+  }
+  return s;
+}
+
+static esp32ir::StaticRxResult<600> g_result; // fits the longest bundled capture
+
+// Every capture three times, polled into a StaticRxResult; with zeroAlloc nothing may allocate after begin().
+static std::vector<std::string> receive(const std::vector<std::vector<int>> &captures, bool rawPlusKnown, bool task,
+                                        bool zeroAlloc)
+{
+  esp32ir::Receiver rx(4, false, 10);
+  if (rawPlusKnown)
+    rx.useRawPlusKnown();
+  rx.setRxBufferCount(4);
+  if (zeroAlloc)
+    rx.setZeroAlloc(true);
+  if (task)
+    rx.useDecodeTask(1, 5, 8192);
+  std::vector<std::string> got;
+  got.reserve(1024);
+  rx.begin();
+  {
+    Counting counting;
+    for (int lap = 0; lap < 3; ++lap)
+    {
+      for (auto &c : captures)
+      {
+        fake_rmt_inject(c);
+        // The decode task delivers late: keep polling for 30 ms.
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(task ? 30 : 0);
+        do
+        {
+          while (rx.poll(g_result))
+          {
+            t_testSide = true;
+            got.push_back(sig(g_result));
+            t_testSide = false;
+          }
+          if (task)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        } while (std::chrono::steady_clock::now() < until);
+      }
+    }
+    const size_t allocs = counting.stop();
+    if (zeroAlloc)
+    {
+      EXPECT(allocs == 0, "RX rawPlusKnown=%d task=%d: %zu allocations after begin()", rawPlusKnown, task, allocs);
+      EXPECT(rx.heapAllocCount() == 0, "RX rawPlusKnown=%d task=%d: heapAllocCount() = %u", rawPlusKnown, task,
+             rx.heapAllocCount());
+    }
+  }
+  rx.end();
+  return got;
+}
+
+static void testReceive(const std::vector<Asset> &assets)
+{
+  std::vector<std::vector<int>> captures;
+  for (auto &a : assets)
+    captures.push_back(toTicks(a.us));
+  // A frame no decoder knows, longer than ITPSBuffer's inline storage: its raw result needs the fixed storage.
+  std::vector<int> longFrame{2500, -2500};
+  for (int i = 0; i < 150; ++i)
+  {
+    longFrame.push_back(700);
+    longFrame.push_back(-700 - 300 * (i % 3));
+  }
+  longFrame.push_back(700);
+  captures.push_back(toTicks(longFrame));
+  for (int rawPlusKnown = 0; rawPlusKnown < 2; ++rawPlusKnown)
+  {
+    const auto want = receive(captures, rawPlusKnown, false, false);
+    EXPECT(want.size() >= 3 * captures.size(), "reference: %zu results", want.size());
+    for (int task = 0; task < 2; ++task)
+    {
+      const auto got = receive(captures, rawPlusKnown, task, true);
+      EXPECT(got == want, "RX rawPlusKnown=%d task=%d: %zu results differ from the default receiver's %zu", rawPlusKnown,
+             task, got.size(), want.size());
+    }
+  }
+}
+
+// Sends of ITPS frames and of protocol messages into a TX buffer fixed at begin().
+static void testTransmit(const std::vector<Asset> &assets)
+{
+  std::vector<esp32ir::ITPSBuffer> frames(assets.size());
+  for (size_t i = 0; i < assets.size(); ++i)
+  {
+    std::vector<int8_t> seq;
+    for (int v : assets[i].us)
+    {
+      int m = (std::abs(v) + 5) / 10;
+      while (m > 127)
+      {
+        seq.push_back(v > 0 ? 127 : -127);
+        m -= 127;
+      }
+      seq.push_back(static_cast<int8_t>(v > 0 ? m : -m));
+    }
+    frames[i].addFrame({10, static_cast<uint16_t>(seq.size()), seq.data(), 0});
+  }
+  esp32ir::Transmitter tx(5);
+  tx.setTxBufferSymbols(256);
+  g_tx.reserve(1024); // the fake RMT's record of sent symbols
+  tx.begin();
+  size_t sent = 0;
+  {
+    Counting counting;
+    for (int lap = 0; lap < 3; ++lap)
+    {
+      for (auto &f : frames)
+        sent += tx.send(f);
+      sent += tx.sendNEC(0x10, 0x22);
+      sent += tx.sendNEC(0x10, 0x22, true);
+      sent += tx.sendSONY(0x01, 0x15, 12);
+      sent += tx.sendAEHA(0x2002, 0x0080BD, 24);
+      sent += tx.sendSamsung(0x0707, 0x0002);
+      sent += tx.sendJVC(0x00C5, 0x0014);
+      sent += tx.sendRC5(0x0105, true);
+      sent += tx.sendRC6(0x000C, 0, false);
+    }
+    const size_t allocs = counting.stop();
+    EXPECT(allocs == 0, "TX: %zu allocations after begin()", allocs);
+  }
+  EXPECT(sent == 3 * (frames.size() + 8), "TX: %zu of %zu sends succeeded", sent, 3 * (frames.size() + 8));
+  tx.end();
+}
+
+int main()
+{
+  const auto assets = loadAssets();
+  EXPECT(!assets.empty(), "no assets under %s", ASSET_DIR);
+  if (!assets.empty())
+  {
+    testReceive(assets);
+    testTransmit(assets);
+  }
+  printf("test_heap: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+// KeyTracker fed synthetic decoded results: the repeat window, NEC/Denon repeat codes, RC5 toggles, HOLD
+// pacing, eviction of the longest idle key and the bounded event queue, checked as PRESS/HOLD/RELEASE
+// sequences with their frame counts and durations.
+#include "ESP32IRPulseCodec.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using esp32ir::Protocol;
+
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+// A decoded frame of proto carrying payload p, from firstUs to lastUs.
+template <typename Payload>
+static esp32ir::RxResult frame(Protocol proto, const Payload &p, int64_t firstUs, int64_t lastUs, uint8_t source = 0)
+{
+  esp32ir::RxResult r;
+  r.status = esp32ir::RxStatus::DECODED;
+  r.protocol = proto;
+  const auto *b = reinterpret_cast<const uint8_t *>(&p);
+  r.payloadStorage.assign(b, b + sizeof(Payload));
+  r.message = {proto, r.payloadStorage.data(), static_cast<uint16_t>(sizeof(Payload)), 0};
+  r.timing.firstEdgeUs = firstUs;
+  r.timing.lastEdgeUs = lastUs;
+  r.source = source;
+  return r;
+}
+
+// "TYPE protocol/source n=count d=durationUs code", one per event ready at nowUs.
+static std::vector<std::string> events(esp32ir::KeyTracker &kt, int64_t nowUs)
+{
+  static const char *const kTypes[] = {"PRESS", "HOLD", "RELEASE"};
+  std::vector<std::string> out;
+  esp32ir::KeyEvent e;
+  while (kt.next(e, nowUs))
+  {
+    char b[96];
+    int n = snprintf(b, sizeof(b), "%s %s/%u n=%u d=%u ", kTypes[static_cast<int>(e.type)],
+                     esp32ir::util::protocolToString(e.protocol), e.source, e.count, e.durationUs);
+    for (unsigned i = 0; i < e.codeLength && n < static_cast<int>(sizeof(b)) - 3; ++i)
+      n += snprintf(b + n, sizeof(b) - n, "%02x", e.code[i]);
+    out.push_back(b);
+  }
+  return out;
+}
+
+static void expectEvents(const char *what, const std::vector<std::string> &got, const std::vector<std::string> &want)
+{
+  if (got == want)
+    return;
+  EXPECT(false, "%s: %zu events, want %zu", what, got.size(), want.size());
+  for (size_t i = 0; i < std::max(got.size(), want.size()); ++i)
+    printf("  got %-44s want %s\n", i < got.size() ? got[i].c_str() : "-", i < want.size() ? want[i].c_str() : "-");
+}
+
+static constexpr int64_t kT0 = 1000000;
+static const esp32ir::payload::NEC kNecPress{0x0010, 0x22, false};
+static const esp32ir::payload::NEC kNecRepeat{0, 0, true};
+
+// NEC held for nine repeat codes (108 ms apart): HOLD every 250 ms from the press, RELEASE only once the line
+// has been quiet for longer than the repeat window.
+static void testHoldAndWindow()
+{
+  esp32ir::KeyTracker kt;
+  EXPECT(kt.feed(frame(Protocol::NEC, kNecPress, kT0, kT0 + 67000)), "press ignored");
+  std::vector<std::string> got = events(kt, kT0 + 67000);
+  int64_t lastUs = 0;
+  for (int i = 1; i <= 9; ++i)
+  {
+    const int64_t startUs = kT0 + i * 108000;
+    lastUs = startUs + 11800;
+    EXPECT(kt.feed(frame(Protocol::NEC, kNecRepeat, startUs, lastUs)), "repeat %d ignored", i);
+    for (auto &e : events(kt, lastUs))
+      got.push_back(e);
+  }
+  expectEvents("hold", got,
+               {"PRESS NEC/0 n=1 d=67000 10002200", "HOLD NEC/0 n=4 d=335800 10002200", "HOLD NEC/0 n=7 d=659800 10002200",
+                "HOLD NEC/0 n=10 d=983800 10002200"});
+  expectEvents("within the window", events(kt, lastUs + 120000), {});
+  expectEvents("window passed", events(kt, lastUs + 120001), {"RELEASE NEC/0 n=10 d=983800 10002200"});
+
+  // A frame after the window is a new press; the stale key is released first even if next() never ran.
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0 + 2000000, kT0 + 2067000));
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0 + 2067000 + 120001, kT0 + 2067000 + 120001 + 67000));
+  expectEvents("frame after the window", events(kt, kT0 + 2300000),
+               {"PRESS NEC/0 n=1 d=67000 10002200", "RELEASE NEC/0 n=1 d=67000 10002200", "PRESS NEC/0 n=1 d=67000 10002200"});
+
+  // Hold interval 0: a HOLD on every repeat frame.
+  esp32ir::KeyTracker every;
+  every.setHoldIntervalUs(0);
+  every.feed(frame(Protocol::NEC, kNecPress, kT0, kT0 + 67000));
+  every.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 108000, kT0 + 119800));
+  every.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 216000, kT0 + 227800));
+  expectEvents("hold interval 0", events(every, kT0 + 227800),
+               {"PRESS NEC/0 n=1 d=67000 10002200", "HOLD NEC/0 n=2 d=119800 10002200", "HOLD NEC/0 n=3 d=227800 10002200"});
+  EXPECT(!kt.setRepeatWindowUs(0), "repeat window 0 accepted");
+}
+
+// Repeat codes carry no code: with no key of their protocol and source down they are ignored, and a Denon
+// repeat does not continue an NEC key.
+static void testRepeatWithoutKey()
+{
+  esp32ir::KeyTracker kt;
+  EXPECT(!kt.feed(frame(Protocol::NEC, kNecRepeat, kT0, kT0 + 11800)), "NEC repeat without a press accepted");
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0 + 100000, kT0 + 167000));
+  EXPECT(!kt.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 208000, kT0 + 219800, 1)), "repeat of another source accepted");
+  EXPECT(!kt.feed(frame(Protocol::Denon, esp32ir::payload::Denon{0, 0, true}, kT0 + 208000, kT0 + 240000)),
+         "Denon repeat continued an NEC key");
+  // A repeat after the window releases the stale key and is itself ignored.
+  EXPECT(!kt.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 167000 + 120001, kT0 + 167000 + 131801)), "late repeat accepted");
+  expectEvents("repeat without key", events(kt, kT0 + 1000000),
+               {"PRESS NEC/0 n=1 d=67000 10002200", "RELEASE NEC/0 n=1 d=67000 10002200"});
+
+  // Denon: press, repeat continues it.
+  esp32ir::KeyTracker denon;
+  denon.feed(frame(Protocol::Denon, esp32ir::payload::Denon{0x0002, 0x0034, false}, kT0, kT0 + 40000));
+  EXPECT(denon.feed(frame(Protocol::Denon, esp32ir::payload::Denon{0, 0, true}, kT0 + 65000, kT0 + 105000)),
+         "Denon repeat ignored");
+  expectEvents("Denon", events(denon, kT0 + 300000),
+               {"PRESS Denon/0 n=1 d=40000 0200340000", "RELEASE Denon/0 n=2 d=105000 0200340000"});
+}
+
+// RC5 resends the whole frame while a key is held (same toggle); pressing again flips the toggle, which is a
+// new press even inside the repeat window. SONY copies continue the key the same way.
+static void testToggleAndCopies()
+{
+  esp32ir::KeyTracker kt;
+  const esp32ir::payload::RC5 first{0x0105, false};
+  const esp32ir::payload::RC5 again{0x0105, true};
+  kt.feed(frame(Protocol::RC5, first, kT0, kT0 + 25000));
+  kt.feed(frame(Protocol::RC5, first, kT0 + 114000, kT0 + 139000));
+  kt.feed(frame(Protocol::RC5, again, kT0 + 228000, kT0 + 253000));
+  const esp32ir::payload::SONY sony{0x0001, 0x0015, 12};
+  for (int i = 0; i < 3; ++i)
+    kt.feed(frame(Protocol::SONY, sony, kT0 + 400000 + i * 45000, kT0 + 420000 + i * 45000));
+  expectEvents("toggle", events(kt, kT0 + 1000000),
+               {"PRESS RC5/0 n=1 d=25000 050100", "RELEASE RC5/0 n=2 d=139000 050100", "PRESS RC5/0 n=1 d=25000 050101",
+                "PRESS SONY/0 n=1 d=20000 010015000c", "RELEASE RC5/0 n=1 d=25000 050101", "RELEASE SONY/0 n=3 d=110000 010015000c"});
+}
+
+// Keys are per protocol and source; with kMaxKeys down a new key releases the one idle longest.
+static void testEviction()
+{
+  static_assert(esp32ir::KeyTracker::kMaxKeys == 4, "test assumes four keys");
+  esp32ir::KeyTracker kt;
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0, kT0 + 67000, 0));
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0 + 1000, kT0 + 68000, 1));
+  kt.feed(frame(Protocol::RC5, esp32ir::payload::RC5{0x0105, false}, kT0 + 2000, kT0 + 27000));
+  kt.feed(frame(Protocol::SONY, esp32ir::payload::SONY{0x0001, 0x0015, 12}, kT0 + 3000, kT0 + 23000));
+  // NEC/0 and SONY continue, leaving NEC/1 idle longest.
+  kt.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 108000, kT0 + 119800, 0));
+  kt.feed(frame(Protocol::SONY, esp32ir::payload::SONY{0x0001, 0x0015, 12}, kT0 + 48000, kT0 + 68000));
+  kt.feed(frame(Protocol::RC5, esp32ir::payload::RC5{0x0105, false}, kT0 + 30000, kT0 + 69000));
+  kt.feed(frame(Protocol::JVC, esp32ir::payload::JVC{0x00C5, 0x0014, 32}, kT0 + 120000, kT0 + 170000));
+  expectEvents("eviction", events(kt, kT0 + 170000),
+               {"PRESS NEC/0 n=1 d=67000 10002200", "PRESS NEC/1 n=1 d=67000 10002200", "PRESS RC5/0 n=1 d=25000 050100",
+                "PRESS SONY/0 n=1 d=20000 010015000c", "RELEASE NEC/1 n=1 d=67000 10002200", "PRESS JVC/0 n=1 d=50000 c500140020"});
+}
+
+// Events past kQueueDepth are dropped and counted; the queued ones come out in order. reset() forgets all.
+static void testDroppedEvents()
+{
+  static_assert(esp32ir::KeyTracker::kQueueDepth == 8, "test assumes eight queued events");
+  esp32ir::KeyTracker kt;
+  kt.setHoldIntervalUs(0);
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0, kT0 + 67000));
+  for (int i = 1; i <= 10; ++i)
+    kt.feed(frame(Protocol::NEC, kNecRepeat, kT0 + i * 108000, kT0 + i * 108000 + 11800));
+  EXPECT(kt.droppedEventCount() == 3, "dropped %u events", kt.droppedEventCount());
+  std::vector<std::string> want{"PRESS NEC/0 n=1 d=67000 10002200"};
+  for (int n = 2; n <= 8; ++n)
+    want.push_back("HOLD NEC/0 n=" + std::to_string(n) + " d=" + std::to_string((n - 1) * 108000 + 11800) + " 10002200");
+  expectEvents("queue", events(kt, kT0 + 1091800), want);
+  // The key is still down and counted every frame, dropped HOLDs included.
+  expectEvents("release after drops", events(kt, kT0 + 1091800 + 120001), {"RELEASE NEC/0 n=11 d=1091800 10002200"});
+
+  kt.feed(frame(Protocol::NEC, kNecPress, kT0 + 2000000, kT0 + 2067000));
+  kt.reset();
+  EXPECT(kt.droppedEventCount() == 0, "reset() kept the dropped count");
+  expectEvents("after reset", events(kt, kT0 + 3000000), {});
+  EXPECT(!kt.feed(frame(Protocol::NEC, kNecRepeat, kT0 + 2108000, kT0 + 2119800)), "repeat continued a reset key");
+}
+
+// Only decoded, non-AC results with a message are tracked.
+static void testIgnored()
+{
+  esp32ir::KeyTracker kt;
+  auto raw = frame(Protocol::NEC, kNecPress, kT0, kT0 + 67000);
+  raw.status = esp32ir::RxStatus::RAW_ONLY;
+  EXPECT(!kt.feed(raw), "RAW_ONLY result tracked");
+  const uint8_t ac[13] = {};
+  EXPECT(!kt.feed(frame(Protocol::DaikinAC, ac, kT0, kT0 + 67000)), "AC result tracked");
+  expectEvents("ignored", events(kt, kT0 + 1000000), {});
+}
+
+int main()
+{
+  testHoldAndWindow();
+  testRepeatWithoutKey();
+  testToggleAndCopies();
+  testEviction();
+  testDroppedEvents();
+  testIgnored();
+  printf("test_key_tracker: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
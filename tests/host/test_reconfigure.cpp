@@ -0,0 +1,174 @@
+// reconfigure() from a second thread while captures stream in as partial-RX chunks: the switch happens between
+// captures, so the results of every capture equal those of a receiver begun fresh with one of the two configs,
+// never a mix. With and without the decode task.
+#include "ESP32IRPulseCodec.h"
+#include "assets.h"
+#include "fake.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+static std::vector<int> toTicks(const std::vector<int> &us, int T = 10)
+{
+  std::vector<int> t;
+  for (int v : us)
+    t.push_back(v < 0 ? -(-v / T) : v / T);
+  return t;
+}
+
+static std::vector<int> join(std::initializer_list<std::vector<int>> frames, int gapUs)
+{
+  std::vector<int> c;
+  for (auto &f : frames)
+  {
+    if (!c.empty())
+      c.push_back(-gapUs);
+    c.insert(c.end(), f.begin(), f.end());
+  }
+  return c;
+}
+
+static std::string sig(const esp32ir::RxResult &r)
+{
+  std::string s = std::to_string(static_cast<int>(r.status)) + esp32ir::util::protocolToString(r.protocol);
+  for (unsigned i = 0; i < r.message.length; ++i)
+  {
+    char b[4];
+    snprintf(b, sizeof(b), "%02x", r.message.data[i]);
+    s += b;
+  }
+  for (uint16_t f = 0; f < r.raw.frameCount(); ++f)
+  {
+    s += "|" + std::to_string(r.raw.frame(f).T_us) + ":";
+    for (uint16_t i = 0; i < r.raw.frame(f).len; ++i)
+      s += std::to_string(r.raw.frame(f).seq[i]) + ",";
+  }
+  return s;
+}
+
+using Results = std::vector<std::string>;
+
+static void setUp(esp32ir::Receiver &rx, const esp32ir::RxConfig &config, bool task)
+{
+  rx.reconfigure(config);
+  rx.setRxBufferSymbols(8);
+  rx.setRxBufferCount(6);
+  rx.setEventQueueDepth(64);
+  if (task)
+    rx.useDecodeTask(1, 5, 8192);
+}
+
+// Stream one capture in chunks at about the pace of the RMT, polling between them, then collect its results.
+// With the decode task they arrive late: wait until they equal one of the references (or give up after
+// 200 ms); without references (building them) wait 30 ms.
+static Results stream(esp32ir::Receiver &rx, const std::vector<int> &ticks, bool task, const Results *a = nullptr,
+                      const Results *b = nullptr)
+{
+  Results got;
+  esp32ir::RxResult r;
+  g_between_chunks = [&]
+  {
+    while (rx.poll(r))
+      got.push_back(sig(r));
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+  };
+  fake_rmt_inject_partial(ticks);
+  g_between_chunks = nullptr;
+  const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(!task ? 0 : a ? 200 : 30);
+  do
+  {
+    while (rx.poll(r))
+      got.push_back(sig(r));
+    if (a && (got == *a || got == *b))
+      break;
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  } while (std::chrono::steady_clock::now() < until);
+  return got;
+}
+
+static void testConcurrent(const std::vector<std::vector<int>> &captures, bool task)
+{
+  // A: learning mode. B: RAW only with a shorter frame gap, so the two split joined captures differently.
+  esp32ir::RxConfig configs[2];
+  configs[0].rawPlusKnown = true;
+  configs[1].rawOnly = true;
+  configs[1].frameGapUs = 15000;
+  std::vector<Results> ref[2];
+  for (int c = 0; c < 2; ++c)
+  {
+    esp32ir::Receiver rx(4, false, 10);
+    setUp(rx, configs[c], task);
+    rx.begin();
+    for (auto &t : captures)
+      ref[c].push_back(stream(rx, t, task));
+    rx.end();
+  }
+  for (size_t i = 0; i < captures.size(); ++i)
+    EXPECT(ref[0][i] != ref[1][i], "capture %zu: both configs give the same results", i);
+
+  esp32ir::Receiver rx(4, false, 10);
+  setUp(rx, configs[0], task);
+  rx.begin();
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> switches{0};
+  std::thread other([&]
+                    {
+    for (uint32_t k = 1; !stop.load(); ++k)
+    {
+      if (rx.reconfigure(configs[k & 1]))
+        ++switches;
+      std::this_thread::sleep_for(std::chrono::microseconds(150));
+    } });
+  int matched[2] = {0, 0};
+  int mixed = 0;
+  for (int rep = 0; rep < 20; ++rep)
+  {
+    for (size_t i = 0; i < captures.size(); ++i)
+    {
+      const Results got = stream(rx, captures[i], task, &ref[0][i], &ref[1][i]);
+      if (got == ref[0][i])
+        ++matched[0];
+      else if (got == ref[1][i])
+        ++matched[1];
+      else if (++mixed <= 3)
+        printf("  task=%d capture %zu: %zu results match neither config\n", task, i, got.size());
+    }
+  }
+  stop = true;
+  other.join();
+  rx.end();
+  printf("task=%d switches=%u config A=%d B=%d mixed=%d\n", task, switches.load(), matched[0], matched[1], mixed);
+  EXPECT(mixed == 0, "task=%d: %d captures decoded with a mix of both configs", task, mixed);
+  EXPECT(matched[0] > 0 && matched[1] > 0, "task=%d: the switch never took effect (A=%d B=%d)", task, matched[0], matched[1]);
+}
+
+int main()
+{
+  const auto assets = loadAssets();
+  EXPECT(!assets.empty(), "no assets under %s", ASSET_DIR);
+  if (assets.empty())
+    return 1;
+  std::vector<std::vector<int>> captures;
+  for (auto &a : assets)
+    captures.push_back(toTicks(a.us));
+  captures.push_back(toTicks(join({assets.front().us, assets.back().us}, 25000)));
+  for (int task = 0; task < 2; ++task)
+    testConcurrent(captures, task);
+  printf("test_reconfigure: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,551 @@
+// Partial-RX replay: a capture handed over in RMT chunks of any size decodes exactly as when it arrives in one
+// piece, including chunk boundaries inside a run longer than 127 counts and at a frame gap, and decode() calls
+// made while a capture is still arriving. Trains of AEHA, Samsung and JVC frames give one result per frame, in
+// order. Noisy captures must decode like clean ones through the glitch filter.
+#include "ESP32IRPulseCodec.h"
+#include "assets.h"
+#include "driver/rmt_tx.h"
+#include "fake.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+
+extern std::vector<rmt_symbol_word_t> g_tx;
+static int failures = 0;
+#define EXPECT(cond, ...)                                      \
+  do                                                           \
+  {                                                            \
+    if (!(cond))                                               \
+    {                                                          \
+      ++failures;                                              \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);              \
+      printf(__VA_ARGS__);                                     \
+      printf("\n");                                            \
+    }                                                          \
+  } while (0)
+
+enum class Mode
+{
+  KNOWN,
+  RAW_ONLY,
+  RAW_PLUS_KNOWN
+};
+
+// Microseconds to RMT ticks at T us per tick; the RMT splits durations above 15 bits into several symbols.
+static std::vector<int> toTicks(const std::vector<int> &us, int T = 10)
+{
+  std::vector<int> t;
+  for (int v : us)
+  {
+    int m = std::abs(v) / T;
+    while (m > 32767)
+    {
+      t.push_back(v < 0 ? -32767 : 32767);
+      m -= 32767;
+    }
+    t.push_back(v < 0 ? -m : m);
+  }
+  return t;
+}
+
+static std::vector<int> join(std::initializer_list<std::vector<int>> frames, int gapUs)
+{
+  std::vector<int> c;
+  for (auto &f : frames)
+  {
+    if (!c.empty())
+      c.push_back(-gapUs);
+    c.insert(c.end(), f.begin(), f.end());
+  }
+  return c;
+}
+
+static std::string sig(const esp32ir::RxResult &r)
+{
+  std::string s = std::to_string(static_cast<int>(r.status)) + esp32ir::util::protocolToString(r.protocol);
+  for (unsigned i = 0; i < r.message.length; ++i)
+  {
+    char b[4];
+    snprintf(b, sizeof(b), "%02x", r.message.data[i]);
+    s += b;
+  }
+  for (uint16_t f = 0; f < r.raw.frameCount(); ++f)
+  {
+    s += "|" + std::to_string(r.raw.frame(f).T_us) + ":";
+    for (uint16_t i = 0; i < r.raw.frame(f).len; ++i)
+      s += std::to_string(r.raw.frame(f).seq[i]) + ",";
+  }
+  return s;
+}
+
+struct Run
+{
+  Mode mode{Mode::KNOWN};
+  uint16_t T_us{10};
+  size_t bufSyms{4096};
+  bool partial{false};
+  bool task{false};
+  bool zeroAlloc{false};
+  uint32_t glitchUs{0};
+  std::function<void(esp32ir::Receiver &)> betweenChunks;
+  esp32ir::RxStats *stats{nullptr}; // filled in before end()
+};
+
+static std::vector<std::string> replay(const Run &cfg, const std::vector<std::vector<int>> &captures)
+{
+  esp32ir::Receiver rx(4, false, cfg.T_us);
+  if (cfg.mode == Mode::RAW_ONLY)
+    rx.useRawOnly();
+  if (cfg.mode == Mode::RAW_PLUS_KNOWN)
+    rx.useRawPlusKnown();
+  rx.setRxBufferSymbols(cfg.bufSyms);
+  rx.setRxBufferCount(4);
+  rx.setEventQueueDepth(64);
+  if (cfg.zeroAlloc)
+  {
+    rx.setZeroAlloc(true);
+    rx.setArenaSymbols(4096);
+  }
+  if (cfg.glitchUs)
+    rx.setGlitchFilterUs(cfg.glitchUs);
+  if (cfg.task)
+    rx.useDecodeTask(1, 5, 8192);
+  rx.begin();
+  std::vector<std::string> res;
+  esp32ir::RxResult r;
+  auto drain = [&]
+  {
+    for (int m = 0; m < (cfg.task ? 50 : 1); ++m)
+    {
+      bool any = false;
+      while (rx.poll(r))
+      {
+        res.push_back(sig(r));
+        any = true;
+      }
+      if (cfg.task && !any)
+        std::this_thread::sleep_for(std::chrono::microseconds(300));
+    }
+  };
+  g_between_chunks = [&]
+  {
+    drain();
+    if (cfg.betweenChunks)
+      cfg.betweenChunks(rx);
+  };
+  for (auto &c : captures)
+  {
+    if (cfg.partial)
+      fake_rmt_inject_partial(c);
+    else
+      fake_rmt_inject(c);
+    drain();
+    drain();
+  }
+  g_between_chunks = nullptr;
+  EXPECT(rx.lossCounters().bufferStarved == 0, "buffer starved");
+  if (cfg.stats)
+    *cfg.stats = rx.stats();
+  rx.end();
+  return res;
+}
+
+static void expectSame(const char *what, const std::vector<std::string> &ref, const std::vector<std::string> &got)
+{
+  if (got == ref)
+    return;
+  for (size_t i = 0; i < std::max(got.size(), ref.size()); ++i)
+  {
+    if (i >= got.size() || i >= ref.size() || got[i] != ref[i])
+    {
+      EXPECT(false, "%s: result %zu of %zu/%zu differs\n  want %s\n  got  %s", what, i, ref.size(), got.size(),
+             i < ref.size() ? ref[i].substr(0, 160).c_str() : "-", i < got.size() ? got[i].substr(0, 160).c_str() : "-");
+      return;
+    }
+  }
+}
+
+static const Asset &asset(const std::vector<Asset> &assets, const char *name)
+{
+  for (auto &a : assets)
+    if (a.name == name)
+      return a;
+  printf("missing asset %s\n", name);
+  exit(1);
+}
+
+// Every chunk size, with and without the decode task and zero-alloc, matches the single-buffer reference.
+static void testChunkSizes(const std::vector<std::vector<int>> &captures)
+{
+  for (Mode mode : {Mode::KNOWN, Mode::RAW_ONLY, Mode::RAW_PLUS_KNOWN})
+  {
+    Run ref;
+    ref.mode = mode;
+    const auto want = replay(ref, captures);
+    EXPECT(!want.empty(), "no reference results");
+    for (size_t syms : {1, 2, 3, 8, 16, 48, 512})
+    {
+      for (int task = 0; task < 2; ++task)
+      {
+        for (int za = 0; za < 2; ++za)
+        {
+          Run run = ref;
+          run.bufSyms = syms;
+          run.partial = true;
+          run.task = task;
+          run.zeroAlloc = za;
+          char what[64];
+          snprintf(what, sizeof(what), "mode=%d syms=%zu task=%d zeroAlloc=%d", static_cast<int>(mode), syms, task, za);
+          expectSame(what, want, replay(run, captures));
+        }
+      }
+    }
+  }
+}
+
+// A run of more than 127 counts is several ITPS entries, and past 15 bits also several RMT symbols; a chunk
+// boundary between those symbols must not end or split the run.
+static void testLongRuns()
+{
+  // 70000 counts of mark, then of space, at T = 1 us: three symbols each. With and without a lead-in the
+  // chunk boundaries of one-symbol chunks fall after the first and after the second part of each run.
+  const std::vector<int> run{32767, 32767, 4466, -600, 250, -32767, -32767, -4466, 300};
+  std::vector<std::vector<int>> captures{run, {300, -600}};
+  captures[1].insert(captures[1].end(), run.begin(), run.end());
+  for (Mode mode : {Mode::RAW_ONLY, Mode::RAW_PLUS_KNOWN})
+  {
+    Run ref;
+    ref.mode = mode;
+    ref.T_us = 1;
+    const auto want = replay(ref, captures);
+    EXPECT(want.size() == captures.size(), "long runs: %zu results", want.size());
+    for (size_t syms = 1; syms <= 8; ++syms)
+    {
+      Run run = ref;
+      run.bufSyms = syms;
+      run.partial = true;
+      char what[48];
+      snprintf(what, sizeof(what), "long runs mode=%d syms=%zu", static_cast<int>(mode), syms);
+      expectSame(what, want, replay(run, captures));
+    }
+  }
+}
+
+// Chunks that end right before, on and right after the symbol holding the gap between two frames.
+static void testBoundaryAtGap(const std::vector<Asset> &assets)
+{
+  const auto &nec = asset(assets, "nec_on.json").us;
+  const auto &sony = asset(assets, "sony_12.json").us;
+  for (int gapUs : {20000, 45000})
+  {
+    const auto ticks = toTicks(join({nec, sony}, gapUs));
+    size_t gapSymbol = 0;
+    for (size_t i = 0; i < ticks.size(); ++i)
+    {
+      if (ticks[i] == -gapUs / 10)
+      {
+        gapSymbol = i / 2;
+        break;
+      }
+    }
+    EXPECT(gapSymbol > 0, "gap not found");
+    for (Mode mode : {Mode::KNOWN, Mode::RAW_PLUS_KNOWN})
+    {
+      Run ref;
+      ref.mode = mode;
+      const auto want = replay(ref, {ticks});
+      for (size_t syms : {gapSymbol, gapSymbol + 1, gapSymbol + 2})
+      {
+        Run run = ref;
+        run.bufSyms = syms;
+        run.partial = true;
+        char what[64];
+        snprintf(what, sizeof(what), "gap=%d mode=%d syms=%zu", gapUs, static_cast<int>(mode), syms);
+        expectSame(what, want, replay(run, {ticks}));
+      }
+    }
+  }
+}
+
+// decode() of an external buffer between the chunks of a capture leaves that capture intact; its own
+// remainder comes from decodeNext(), not from poll().
+static void testDecodeWhileStreaming(const std::vector<Asset> &assets)
+{
+  const auto &nec = asset(assets, "nec_on.json").us;
+  const auto &rep = asset(assets, "nec_repeat.json").us;
+  const auto &sony = asset(assets, "sony_12.json").us;
+  std::vector<int8_t> seq;
+  for (int v : join({nec, rep}, 40000))
+  {
+    int m = (std::abs(v) + 5) / 10;
+    while (m > 127)
+    {
+      seq.push_back(v > 0 ? 127 : -127);
+      m -= 127;
+    }
+    seq.push_back(static_cast<int8_t>(v > 0 ? m : -m));
+  }
+  esp32ir::ITPSBuffer ext;
+  ext.addFrame({10, static_cast<uint16_t>(seq.size()), seq.data(), 0});
+
+  const std::vector<std::vector<int>> captures{toTicks(join({sony, nec, rep}, 30000)), toTicks(sony)};
+  for (Mode mode : {Mode::KNOWN, Mode::RAW_PLUS_KNOWN})
+  {
+    Run ref;
+    ref.mode = mode;
+    const auto want = replay(ref, captures);
+    for (int task = 0; task < 2; ++task)
+    {
+      int decoded = 0;
+      int repeats = 0;
+      Run run = ref;
+      run.bufSyms = 16;
+      run.partial = true;
+      run.task = task;
+      run.betweenChunks = [&](esp32ir::Receiver &rx)
+      {
+        esp32ir::RxResult r;
+        if (rx.decode(ext, r) && r.protocol == esp32ir::Protocol::NEC && r.status == esp32ir::RxStatus::DECODED)
+          ++decoded;
+        while (rx.decodeNext(r))
+          repeats += r.protocol == esp32ir::Protocol::NEC;
+      };
+      char what[48];
+      snprintf(what, sizeof(what), "decode while streaming mode=%d task=%d", static_cast<int>(mode), task);
+      expectSame(what, want, replay(run, captures));
+      EXPECT(decoded > 0 && repeats == decoded, "%s: decoded=%d repeats=%d", what, decoded, repeats);
+    }
+  }
+}
+
+// The rest of a decode() input never overtakes frames already captured: poll() keeps returning the SONY copies
+// of a pending capture, and the NEC repeat comes from decodeNext().
+static void testDecodeOrder(const std::vector<Asset> &assets)
+{
+  const auto &sony = asset(assets, "sony_12.json").us;
+  std::vector<int8_t> seq;
+  for (int v : join({asset(assets, "nec_on.json").us, asset(assets, "nec_repeat.json").us}, 40000))
+  {
+    int m = (std::abs(v) + 5) / 10;
+    while (m > 127)
+    {
+      seq.push_back(v > 0 ? 127 : -127);
+      m -= 127;
+    }
+    seq.push_back(static_cast<int8_t>(v > 0 ? m : -m));
+  }
+  esp32ir::ITPSBuffer ext;
+  ext.addFrame({10, static_cast<uint16_t>(seq.size()), seq.data(), 0});
+  for (Mode mode : {Mode::KNOWN, Mode::RAW_PLUS_KNOWN})
+  {
+    esp32ir::Receiver rx(4, false, 10);
+    if (mode == Mode::RAW_PLUS_KNOWN)
+      rx.useRawPlusKnown();
+    rx.begin();
+    fake_rmt_inject(toTicks(sony));
+    esp32ir::RxResult r;
+    std::vector<esp32ir::Protocol> polled;
+    EXPECT(rx.poll(r) && r.protocol == esp32ir::Protocol::SONY, "first SONY copy");
+    EXPECT(rx.decode(ext, r) && r.protocol == esp32ir::Protocol::NEC, "decode() NEC");
+    while (rx.poll(r))
+      polled.push_back(r.protocol);
+    EXPECT(polled.size() == 2 && polled[0] == esp32ir::Protocol::SONY && polled[1] == esp32ir::Protocol::SONY,
+           "mode=%d: poll after decode() returned %zu results, first %s", static_cast<int>(mode), polled.size(),
+           polled.empty() ? "-" : esp32ir::util::protocolToString(polled[0]));
+    EXPECT(rx.decodeNext(r) && r.protocol == esp32ir::Protocol::NEC, "decodeNext() NEC repeat");
+    EXPECT(!rx.decodeNext(r), "decodeNext() after the last frame");
+    rx.end();
+  }
+}
+
+// One frame as the transmitter sends it, in us (sign = level), without the trailing gap.
+template <typename Send>
+static std::vector<int> transmitted(esp32ir::Transmitter &tx, Send send)
+{
+  g_tx.clear();
+  EXPECT(send(tx), "send failed");
+  std::vector<int> us;
+  for (const auto &s : g_tx)
+  {
+    for (int v : {s.level0 ? +s.duration0 : -s.duration0, s.level1 ? +s.duration1 : -s.duration1})
+    {
+      if (v == 0)
+        continue;
+      if (!us.empty() && (us.back() > 0) == (v > 0))
+        us.back() += v;
+      else
+        us.push_back(v);
+    }
+  }
+  while (!us.empty() && us.back() < 0)
+    us.pop_back();
+  return us;
+}
+
+// The result sig() of a decoded payload, without raw frames.
+template <typename P>
+static std::string decoded(esp32ir::Protocol proto, const P &p)
+{
+  std::string s = std::to_string(static_cast<int>(esp32ir::RxStatus::DECODED)) + esp32ir::util::protocolToString(proto);
+  const auto *b = reinterpret_cast<const uint8_t *>(&p);
+  for (size_t i = 0; i < sizeof(P); ++i)
+  {
+    char h[4];
+    snprintf(h, sizeof(h), "%02x", b[i]);
+    s += h;
+  }
+  return s;
+}
+
+// Frames closer together than the frame gap arrive as one capture. Each decoded frame ends at its protocol's
+// longest symbol and the rest decodes next, so a train gives one result per frame in order, whole or in chunks.
+static void testTrains()
+{
+  const esp32ir::payload::AEHA a1{0x2002, 0x0080BD, 24};
+  const esp32ir::payload::AEHA a2{0x2002, 0x1030A0, 24};
+  const esp32ir::payload::Samsung sam{0x0707, 0x0002};
+  const esp32ir::payload::JVC jvc{0x00C5, 0x0014, 32};
+  esp32ir::Transmitter tx(5);
+  tx.begin();
+  const auto aeha1 = transmitted(tx, [&](esp32ir::Transmitter &t) { return t.sendAEHA(a1); });
+  const auto aeha2 = transmitted(tx, [&](esp32ir::Transmitter &t) { return t.sendAEHA(a2); });
+  const auto samsung = transmitted(tx, [&](esp32ir::Transmitter &t) { return t.sendSamsung(sam); });
+  const auto jvcFrame = transmitted(tx, [&](esp32ir::Transmitter &t) { return t.sendJVC(jvc); });
+  tx.end();
+  const std::string A1 = decoded(esp32ir::Protocol::AEHA, a1);
+  const std::string A2 = decoded(esp32ir::Protocol::AEHA, a2);
+  const std::string S = decoded(esp32ir::Protocol::Samsung, sam);
+  const std::string J = decoded(esp32ir::Protocol::JVC, jvc);
+  struct Train
+  {
+    const char *name;
+    std::vector<int> us;
+    std::vector<std::string> want;
+  } trains[] = {
+      // Frames of about 50 ms each; a train stays within the 200 ms maxFrameUs of a receiver with every protocol.
+      {"AEHA", join({aeha1, aeha2, aeha1}, 10000), {A1, A2, A1}},
+      {"Samsung repeat", join({samsung, samsung}, 55000), {S, S}},
+      {"JVC repeat", join({jvcFrame, jvcFrame}, 20000), {J, J}},
+      {"JVC Samsung AEHA", join({jvcFrame, samsung, aeha2}, 12000), {J, S, A2}},
+  };
+  for (auto &t : trains)
+  {
+    for (Mode mode : {Mode::KNOWN, Mode::RAW_PLUS_KNOWN})
+    {
+      for (size_t syms : {4096, 8, 13})
+      {
+        for (int task = 0; task < 2; ++task)
+        {
+          Run run;
+          run.mode = mode;
+          run.bufSyms = syms;
+          run.partial = syms < 4096;
+          run.task = task;
+          auto got = replay(run, {toTicks(t.us)});
+          for (auto &g : got)
+            g = g.substr(0, g.find('|'));
+          char what[80];
+          snprintf(what, sizeof(what), "%s train mode=%d syms=%zu task=%d", t.name, static_cast<int>(mode), syms, task);
+          expectSame(what, t.want, got);
+        }
+      }
+    }
+  }
+}
+
+// Noise as a sunlit or CFL-lit receiver sees it: 20-80 us spikes of the other level inside marks and spaces,
+// and a burst of short marks on the idle line ahead of the frame. Returns the noisy capture (in us) and the
+// number of pulses the glitch filter must merge away.
+static std::vector<int> addNoise(const std::vector<int> &us, std::mt19937 &rng, uint32_t &spikes)
+{
+  std::vector<int> out;
+  const int burst = 2 + static_cast<int>(rng() % 4);
+  for (int i = 0; i < burst; ++i)
+  {
+    out.push_back(20 + static_cast<int>(rng() % 61));      // short mark on the idle line
+    out.push_back(-(300 + static_cast<int>(rng() % 400))); // idle between them (longer than the filter)
+    ++spikes;
+  }
+  out.back() -= 5000; // quiet before the frame
+  for (int v : us)
+  {
+    const int len = std::abs(v);
+    const int spike = 20 + static_cast<int>(rng() % 61);
+    if (len >= 500 && rng() % 3 == 0)
+    {
+      // v splits into head, spike of the other level, tail; head and tail stay longer than the filter.
+      const int head = (len - spike) / 2;
+      const int tail = len - spike - head;
+      const int sign = v > 0 ? 1 : -1;
+      out.push_back(sign * head);
+      out.push_back(-sign * spike);
+      out.push_back(sign * tail);
+      ++spikes;
+    }
+    else
+    {
+      out.push_back(v);
+    }
+  }
+  return out;
+}
+
+// With the glitch filter on, a noisy capture decodes like the clean one, whole or in 8/13-symbol partial-RX
+// chunks (the held pulse crosses chunk boundaries), and stats().glitches counts every spike.
+static void testGlitches(const std::vector<Asset> &assets)
+{
+  std::mt19937 rng(17);
+  std::vector<std::vector<int>> clean;
+  std::vector<std::vector<int>> noisy;
+  uint32_t spikes = 0;
+  for (int lap = 0; lap < 3; ++lap)
+  {
+    for (auto &a : assets)
+    {
+      clean.push_back(toTicks(a.us));
+      noisy.push_back(toTicks(addNoise(a.us, rng, spikes)));
+    }
+  }
+  Run ref;
+  ref.glitchUs = 100;
+  const auto want = replay(ref, clean);
+  EXPECT(want.size() >= clean.size(), "glitch reference: %zu results", want.size());
+  Run unfiltered;
+  EXPECT(replay(unfiltered, noisy) != want, "noise does not disturb decoding without the filter");
+  for (size_t syms : {4096, 8, 13})
+  {
+    esp32ir::RxStats st{};
+    Run run = ref;
+    run.bufSyms = syms;
+    run.partial = syms < 4096;
+    run.stats = &st;
+    char what[40];
+    snprintf(what, sizeof(what), "glitch filter syms=%zu", syms);
+    expectSame(what, want, replay(run, noisy));
+    EXPECT(st.glitches == spikes, "%s: glitches=%u, %u spikes injected", what, st.glitches, spikes);
+  }
+}
+
+int main()
+{
+  const auto assets = loadAssets();
+  EXPECT(!assets.empty(), "no assets under %s", ASSET_DIR);
+  std::vector<std::vector<int>> captures;
+  for (auto &a : assets)
+    captures.push_back(toTicks(a.us));
+  captures.push_back(toTicks(join({asset(assets, "nec_on.json").us, asset(assets, "nec_repeat.json").us,
+                                   asset(assets, "nec_repeat.json").us},
+                                  40000)));
+  captures.push_back(toTicks(join({asset(assets, "sony_15.json").us, asset(assets, "nec_off.json").us}, 25000)));
+  testChunkSizes(captures);
+  testLongRuns();
+  testBoundaryAtGap(assets);
+  testDecodeWhileStreaming(assets);
+  testDecodeOrder(assets);
+  testTrains();
+  testGlitches(assets);
+  printf("test_replay: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
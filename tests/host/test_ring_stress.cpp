@@ -0,0 +1,164 @@
+// RxEventRing under two threads: a producer that fills receive buffers, marks them in the pending mask and
+// pushes with DROP_OLDEST, and a consumer that pops and checks the buffer contents and FIFO order. Every depth
+// runs from counter 0 and from just below the counter wrap.
+#include "core/rx_event_ring.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static constexpr int kBuffers = 6;
+static constexpr int kSyms = 16;
+static constexpr uint32_t kNearWrap = 0x7FFFFF00u; // below the wrap of every depth up to 256
+static uint32_t g_buf[kBuffers][kSyms];
+static std::atomic<uint32_t> g_mask{0};
+static int failures = 0;
+
+// Single thread: fill, drain and refill across the wrap; full and empty must hold at every position.
+static void testWrap(size_t depth)
+{
+  esp32ir::RxEventRing ring;
+  ring.init(depth, kNearWrap);
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int round = 0; round < 600; ++round)
+  {
+    size_t n = 1 + round % depth;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (!ring.push({0, false, pushed++ & esp32ir::RxEventDesc::kMaxSymbols}))
+      {
+        printf("depth=%zu: push %u failed with %zu queued\n", depth, pushed - 1, ring.size());
+        ++failures;
+        return;
+      }
+    }
+    if (n == depth && ring.push({0, false, 0}))
+    {
+      printf("depth=%zu: push into a full ring\n", depth);
+      ++failures;
+      return;
+    }
+    esp32ir::RxEventDesc ev{};
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (!ring.pop(ev) || ev.symbols != (popped++ & esp32ir::RxEventDesc::kMaxSymbols))
+      {
+        printf("depth=%zu: pop %u out of order\n", depth, popped - 1);
+        ++failures;
+        return;
+      }
+    }
+    if (ring.size() != 0 || ring.pop(ev))
+    {
+      printf("depth=%zu: ring not empty after draining\n", depth);
+      ++failures;
+      return;
+    }
+  }
+}
+
+static void testThreads(size_t depth, uint32_t first, uint32_t N)
+{
+  esp32ir::RxEventRing ring;
+  ring.init(depth, first);
+  g_mask = 0;
+  std::vector<uint8_t> seen(N, 0); // 1 consumed, 2 dropped, 3 starved
+  std::atomic<bool> done{false};
+  std::atomic<bool> producerFailed{false};
+  uint32_t dropped = 0;
+  uint32_t starved = 0;
+  std::thread prod([&]
+                   {
+    for (uint32_t seq = 0; seq < N; ++seq)
+    {
+      uint32_t m = g_mask.load(std::memory_order_acquire);
+      int b = -1;
+      for (int i = 0; i < kBuffers; ++i)
+      {
+        if (!(m & (1u << i)))
+        {
+          b = i;
+          break;
+        }
+      }
+      if (b < 0)
+      {
+        ++starved;
+        seen[seq] = 3;
+        std::this_thread::yield();
+        continue;
+      }
+      for (int k = 0; k < kSyms; ++k)
+        g_buf[b][k] = seq * 31 + k;
+      g_mask.fetch_or(1u << b, std::memory_order_relaxed);
+      esp32ir::RxEventDesc ev{static_cast<uint8_t>(b), true, seq & esp32ir::RxEventDesc::kMaxSymbols};
+      if (!ring.push(ev))
+      {
+        esp32ir::RxEventDesc old{};
+        if (ring.dropOldest(old))
+        {
+          // The seq of the dropped event is recovered from its buffer's first word.
+          uint32_t s = g_buf[old.buffer][0] / 31;
+          if (old.symbols != (s & esp32ir::RxEventDesc::kMaxSymbols))
+            producerFailed = true;
+          seen[s] = 2;
+          ++dropped;
+          g_mask.fetch_and(~(1u << old.buffer), std::memory_order_release);
+        }
+        if (!ring.push(ev))
+          producerFailed = true;
+      }
+      if (((seq * 2654435761u) >> 29) == 0)
+        std::this_thread::yield();
+    }
+    done = true; });
+  uint64_t consumed = 0;
+  uint64_t bad = 0;
+  int64_t lastSeq = -1;
+  for (;;)
+  {
+    esp32ir::RxEventDesc ev{};
+    if (!ring.pop(ev))
+    {
+      if (done.load() && ring.size() == 0)
+        break;
+      std::this_thread::yield();
+      continue;
+    }
+    if ((consumed * 40503u >> 13 & 7) == 0)
+      std::this_thread::yield();
+    uint32_t s = g_buf[ev.buffer][0] / 31;
+    for (int k = 0; k < kSyms; ++k)
+      bad += g_buf[ev.buffer][k] != s * 31 + k;
+    bad += (s & esp32ir::RxEventDesc::kMaxSymbols) != ev.symbols;
+    bad += static_cast<int64_t>(s) <= lastSeq; // FIFO order
+    lastSeq = s;
+    seen[s] = 1;
+    ++consumed;
+    g_mask.fetch_and(~(1u << ev.buffer), std::memory_order_release);
+  }
+  prod.join();
+  uint64_t c[4] = {};
+  for (auto v : seen)
+    ++c[v];
+  const bool ok = !producerFailed && bad == 0 && c[0] == 0 && c[1] == consumed && c[2] == dropped && c[3] == starved;
+  printf("depth=%zu first=%08x consumed=%llu dropped=%u starved=%u bad=%llu lost=%llu %s\n", depth, first,
+         static_cast<unsigned long long>(consumed), dropped, starved, static_cast<unsigned long long>(bad),
+         static_cast<unsigned long long>(c[0]), ok ? "OK" : "FAIL");
+  failures += !ok;
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t N = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 300000;
+  for (size_t depth : {1, 2, 3, 5, 6, 7, 8, 13})
+  {
+    testWrap(depth);
+    testThreads(depth, 0, N);
+    testThreads(depth, kNearWrap, N);
+  }
+  printf("test_ring_stress: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// SpscRing under two threads: the producer fills slots in place and publishes them, the consumer reads them in
+// place and checks contents and FIFO order. Slots keep their buffers, so after the first lap nothing grows.
+#include "core/spsc_ring.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+struct Item
+{
+  uint32_t seq{0};
+  std::vector<uint32_t> data;
+};
+
+static int failures = 0;
+
+static void testThreads(size_t depth, uint32_t N)
+{
+  esp32ir::SpscRing<Item> ring;
+  ring.init(depth);
+  ring.forEachSlot([](Item &slot) { slot.data.reserve(64); });
+  std::atomic<bool> done{false};
+  uint32_t full = 0;
+  uint32_t grown = 0;
+  std::thread prod([&]
+                   {
+    for (uint32_t seq = 0; seq < N;)
+    {
+      Item *slot = ring.writeSlot();
+      if (!slot)
+      {
+        ++full;
+        std::this_thread::yield();
+        continue;
+      }
+      const size_t cap = slot->data.capacity();
+      slot->seq = seq;
+      slot->data.assign(1 + seq % 64, seq * 7u);
+      grown += slot->data.capacity() != cap;
+      ring.publish();
+      ++seq;
+      if (((seq * 2654435761u) >> 29) == 0)
+        std::this_thread::yield();
+    }
+    done = true; });
+  uint64_t consumed = 0;
+  uint64_t bad = 0;
+  for (;;)
+  {
+    Item *slot = ring.readSlot();
+    if (!slot)
+    {
+      if (done.load() && ring.size() == 0)
+        break;
+      std::this_thread::yield();
+      continue;
+    }
+    bad += slot->seq != consumed; // FIFO order, nothing lost or repeated
+    bad += slot->data.size() != 1 + slot->seq % 64;
+    for (uint32_t v : slot->data)
+      bad += v != slot->seq * 7u;
+    if ((consumed * 40503u >> 13 & 7) == 0)
+      std::this_thread::yield();
+    ring.pop();
+    ++consumed;
+  }
+  prod.join();
+  const bool ok = bad == 0 && consumed == N && grown == 0 && ring.size() == 0;
+  printf("depth=%zu consumed=%llu full=%u grown=%u bad=%llu %s\n", depth, static_cast<unsigned long long>(consumed), full,
+         grown, static_cast<unsigned long long>(bad), ok ? "OK" : "FAIL");
+  failures += !ok;
+}
+
+// Single thread: capacity, full and empty at every fill level.
+static void testFill(size_t depth)
+{
+  esp32ir::SpscRing<Item> ring;
+  ring.init(depth);
+  bool ok = ring.capacity() == depth;
+  for (int round = 0; ok && round < 50; ++round)
+  {
+    size_t n = 1 + round % depth;
+    for (size_t i = 0; i < n; ++i)
+    {
+      Item *slot = ring.writeSlot();
+      ok = ok && slot;
+      if (slot)
+      {
+        slot->seq = static_cast<uint32_t>(round * 100 + i);
+        ring.publish();
+      }
+    }
+    ok = ok && ring.size() == n && (n < depth || ring.writeSlot() == nullptr);
+    for (size_t i = 0; ok && i < n; ++i)
+    {
+      Item *slot = ring.readSlot();
+      ok = slot && slot->seq == round * 100 + i;
+      ring.pop();
+    }
+    ok = ok && ring.readSlot() == nullptr && ring.size() == 0;
+  }
+  if (!ok)
+  {
+    printf("depth=%zu: fill/drain FAIL\n", depth);
+    ++failures;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t N = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 300000;
+  for (size_t depth : {1, 2, 3, 7, 8})
+  {
+    testFill(depth);
+    testThreads(depth, N);
+  }
+  printf("test_spsc_stress: %s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}